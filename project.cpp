@@ -1,7 +1,7 @@
 /*
  * Flashcard Study System
  *
- * Compilation: g++ -std=c++17 -o project project.cpp
+ * Compilation: g++ -std=c++17 -pthread -o project project.cpp
  * Author: Group Project
  * Date: February 2026
  */
@@ -9,15 +9,32 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <cstdlib>
+#include <cctype>
+#include <cstring>
 #include <ctime>
 #include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+#include <atomic>
+#include <unordered_map>
+#include <random>
+#include <new>
 #include <sys/stat.h>
 #include <sys/types.h>
 
 #ifdef _WIN32
 #include <direct.h>
+#include <fcntl.h>
+#include <io.h>
 #include <windows.h>
 #else
 #include <dirent.h>
@@ -26,6 +43,25 @@
 
 using namespace std;
 
+// Heap allocations made through operator new, counted for --bench-memory.
+// GCC warns about new/delete mismatches when a replaced operator delete
+// is inlined next to operator new, so the deletes are kept out of line.
+#if defined(__GNUC__)
+#define NO_INLINE __attribute__((noinline))
+#else
+#define NO_INLINE
+#endif
+
+atomic<uint64_t> allocationCount{0};
+
+void* operator new(size_t size) {
+    allocationCount.fetch_add(1, memory_order_relaxed);
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw bad_alloc();
+}
+NO_INLINE void operator delete(void* p) noexcept { free(p); }
+NO_INLINE void operator delete(void* p, size_t) noexcept { free(p); }
+
 // Cross-platform filesystem helpers (no C++17 filesystem required)
 bool dirExists(const string& path) {
     struct stat info;
@@ -53,6 +89,26 @@ bool deleteFileFs(const string& path) {
 #endif
 }
 
+bool removeDirFs(const string& path) {
+#ifdef _WIN32
+    return _rmdir(path.c_str()) == 0;
+#else
+    return rmdir(path.c_str()) == 0;
+#endif
+}
+
+bool truncateFileFs(const string& path, long size) {
+#ifdef _WIN32
+    int fd = _open(path.c_str(), _O_RDWR | _O_BINARY);
+    if (fd < 0) return false;
+    bool ok = _chsize_s(fd, size) == 0;
+    _close(fd);
+    return ok;
+#else
+    return truncate(path.c_str(), size) == 0;
+#endif
+}
+
 vector<string> listTxtFiles(const string& folderPath) {
     vector<string> files;
 #ifdef _WIN32
@@ -83,18 +139,286 @@ vector<string> listTxtFiles(const string& folderPath) {
     return files;
 }
 
-class Question {
+// Turn user-entered tags into the stored form: lowercase names separated
+// by single spaces, without duplicates. Commas also separate tags, and
+// characters used by the file format or tag queries are dropped.
+string normalizeTags(string_view input) {
+    vector<string> names;
+    string current;
+    for (size_t i = 0; i <= input.size(); ++i) {
+        char c = i < input.size() ? input[i] : ' ';
+        if (isspace((unsigned char)c) || c == ',') {
+            if (!current.empty() && find(names.begin(), names.end(), current) == names.end()) {
+                names.push_back(current);
+            }
+            current.clear();
+        } else if (c != '(' && c != ')' && c != '|' && c != '#') {
+            current += (char)tolower((unsigned char)c);
+        }
+    }
+    string result;
+    for (const string& name : names) {
+        if (!result.empty()) result += ' ';
+        result += name;
+    }
+    return result;
+}
+
+// True if tags is already in the form normalizeTags returns; checked
+// without allocating, since the loader asks this for every tagged question
+bool isNormalizedTags(string_view tags) {
+    if (tags.empty()) return true;
+    if (tags.front() == ' ' || tags.back() == ' ') return false;
+    for (size_t i = 0; i < tags.size(); ++i) {
+        unsigned char c = (unsigned char)tags[i];
+        if (c == ' ') {
+            if (tags[i - 1] == ' ') return false;
+        } else if (isspace(c) || c == ',' || c == '(' || c == ')' || c == '|' || c == '#' ||
+                   tolower(c) != c) {
+            return false;
+        }
+    }
+    // No duplicates: compare each name with the names after it
+    for (size_t start = 0; start < tags.size();) {
+        size_t end = min(tags.find(' ', start), tags.size());
+        string_view name = tags.substr(start, end - start);
+        for (size_t other = end + 1; other < tags.size();) {
+            size_t otherEnd = min(tags.find(' ', other), tags.size());
+            if (tags.substr(other, otherEnd - other) == name) return false;
+            other = otherEnd + 1;
+        }
+        start = end + 1;
+    }
+    return true;
+}
+
+// Call visit() for each name in a normalized tag list
+template <typename Visit>
+void forEachTag(string_view tags, Visit visit) {
+    while (!tags.empty()) {
+        size_t space = tags.find(' ');
+        visit(tags.substr(0, space));
+        if (space == string_view::npos) break;
+        tags.remove_prefix(space + 1);
+    }
+}
+
+// Parse an id exactly as saving writes it: one space, then the number
+// without leading zeros. Ids are sparse keys, so any value below
+// UINT32_MAX is accepted (one is left free so the next id never wraps).
+bool parseId(string_view text, uint32_t& id) {
+    if (text.size() < 2 || text.front() != ' ') return false;
+    text.remove_prefix(1);
+    if (text.size() > 10 || (text.size() > 1 && text.front() == '0')) return false;
+    uint64_t value = 0;
+    for (char c : text) {
+        if (!isdigit((unsigned char)c)) return false;
+        value = value * 10 + (uint64_t)(c - '0');
+    }
+    if (value >= UINT32_MAX) return false;
+    id = (uint32_t)value;
+    return true;
+}
+
+// A question line of a deck file is "question|answer", optionally followed
+// by "|#tags: a b" and then "|#id: N". A suffix only counts when it is
+// exactly what saving writes (normalized tags, a plain number), so older
+// decks whose answers merely contain "|#tags:" or "|#id:" load unchanged.
+struct QuestionLine {
+    string_view question;
+    string_view answer;
+    string_view tags;
+    bool hasId = false;
+    uint32_t id = 0;
+};
+
+bool parseQuestionLine(string_view line, QuestionLine& out) {
+    const string_view tagsMarker = "|#tags:";
+    const string_view idMarker = "|#id:";
+    size_t separatorIndex = line.find('|');
+    if (separatorIndex == string_view::npos) return false;
+    out = QuestionLine();
+    out.question = line.substr(0, separatorIndex);
+    string_view answer = line.substr(separatorIndex + 1);
+
+    size_t idIndex = answer.rfind(idMarker);
+    if (idIndex != string_view::npos &&
+        parseId(answer.substr(idIndex + idMarker.size()), out.id)) {
+        out.hasId = true;
+        answer = answer.substr(0, idIndex);
+    }
+    size_t tagsIndex = answer.rfind(tagsMarker);
+    if (tagsIndex != string_view::npos) {
+        string_view tags = answer.substr(tagsIndex + tagsMarker.size());
+        if (!tags.empty() && tags.front() == ' ') tags.remove_prefix(1);
+        if (isNormalizedTags(tags)) {
+            out.tags = tags;
+            answer = answer.substr(0, tagsIndex);
+        }
+    }
+    out.answer = answer;
+    return true;
+}
+
+// Append a question line to a deck file's text. The id is written only if
+// writeId is set, unless the answer itself ends in something that would
+// read back as a suffix: then both suffixes are written, which makes the
+// line unambiguous ("|#tags:" with nothing after it means no tags).
+void appendQuestionLine(string& out, string_view question, string_view answer,
+                        string_view tags, uint32_t id, bool writeId) {
+    size_t start = out.size();
+    out += question;
+    out += '|';
+    out += answer;
+    if (!tags.empty()) {
+        out += "|#tags: ";
+        out += tags;
+    }
+    if (writeId) out += "|#id: " + to_string(id);
+
+    QuestionLine check;
+    parseQuestionLine(string_view(out).substr(start), check);
+    if (check.answer.size() != answer.size() || check.hasId != writeId) {
+        out.resize(start);
+        out += question;
+        out += '|';
+        out += answer;
+        out += "|#tags:";
+        if (!tags.empty()) {
+            out += ' ';
+            out += tags;
+        }
+        out += "|#id: " + to_string(id);
+    }
+    out += '\n';
+}
+
+// Questions of one deck, stored as a struct of arrays: all text lives in
+// one character buffer and each question/answer/tag list is an offset and
+// length into it. Edited text is appended to the buffer; the buffer is
+// compacted once more than half of it is unreferenced. Each question also
+// keeps a stable id, which the review history uses to refer to it.
+class QuestionStore {
+private:
+    string text;
+    vector<uint32_t> questionOffset, questionLength;
+    vector<uint32_t> answerOffset, answerLength;
+    vector<uint32_t> tagsOffset, tagsLength;
+    vector<uint32_t> ids;
+    uint32_t nextId = 0;
+    size_t garbage = 0;
+
+    uint32_t append(string_view s) {
+        uint32_t offset = (uint32_t)text.size();
+        text.append(s.data(), s.size());
+        return offset;
+    }
+
+    void compactIfNeeded() {
+        if (garbage < 4096 || garbage < text.size() / 2) return;
+        string packed;
+        packed.reserve(text.size() - garbage);
+        for (size_t i = 0; i < size(); ++i) {
+            uint32_t q = (uint32_t)packed.size();
+            packed.append(text, questionOffset[i], questionLength[i]);
+            uint32_t a = (uint32_t)packed.size();
+            packed.append(text, answerOffset[i], answerLength[i]);
+            uint32_t t = (uint32_t)packed.size();
+            packed.append(text, tagsOffset[i], tagsLength[i]);
+            questionOffset[i] = q;
+            answerOffset[i] = a;
+            tagsOffset[i] = t;
+        }
+        text.swap(packed);
+        garbage = 0;
+    }
+
 public:
-    string question;
-    string answer;
-    Question() = default;
-    Question(const string& q, const string& a) : question(q), answer(a) {}
+    size_t size() const { return questionOffset.size(); }
+    bool empty() const { return questionOffset.empty(); }
+
+    // Views stay valid until the next add/set/erase on this store
+    string_view question(size_t i) const {
+        return string_view(text).substr(questionOffset[i], questionLength[i]);
+    }
+    string_view answer(size_t i) const {
+        return string_view(text).substr(answerOffset[i], answerLength[i]);
+    }
+    // Space-separated tag names (see normalizeTags)
+    string_view tags(size_t i) const {
+        return string_view(text).substr(tagsOffset[i], tagsLength[i]);
+    }
+
+    uint32_t id(size_t i) const { return ids[i]; }
+    uint32_t getNextId() const { return nextId; }
+    void reserveIds(uint32_t next) { nextId = max(nextId, next); }
+
+    void reserve(size_t questions, size_t bytes) {
+        questionOffset.reserve(questions);
+        questionLength.reserve(questions);
+        answerOffset.reserve(questions);
+        answerLength.reserve(questions);
+        tagsOffset.reserve(questions);
+        tagsLength.reserve(questions);
+        ids.reserve(questions);
+        text.reserve(bytes);
+    }
+
+    void add(string_view q, string_view a, string_view t = "") {
+        addWithId(nextId, q, a, t);
+    }
+
+    void addWithId(uint32_t questionId, string_view q, string_view a, string_view t) {
+        ids.push_back(questionId);
+        nextId = max(nextId, questionId + 1);
+        questionOffset.push_back(append(q));
+        questionLength.push_back((uint32_t)q.size());
+        answerOffset.push_back(append(a));
+        answerLength.push_back((uint32_t)a.size());
+        tagsOffset.push_back(append(t));
+        tagsLength.push_back((uint32_t)t.size());
+    }
+
+    void setQuestion(size_t i, string_view q) {
+        garbage += questionLength[i];
+        questionOffset[i] = append(q);
+        questionLength[i] = (uint32_t)q.size();
+        compactIfNeeded();
+    }
+
+    void setAnswer(size_t i, string_view a) {
+        garbage += answerLength[i];
+        answerOffset[i] = append(a);
+        answerLength[i] = (uint32_t)a.size();
+        compactIfNeeded();
+    }
+
+    void setTags(size_t i, string_view t) {
+        garbage += tagsLength[i];
+        tagsOffset[i] = append(t);
+        tagsLength[i] = (uint32_t)t.size();
+        compactIfNeeded();
+    }
+
+    void erase(size_t i) {
+        garbage += questionLength[i] + answerLength[i] + tagsLength[i];
+        questionOffset.erase(questionOffset.begin() + i);
+        questionLength.erase(questionLength.begin() + i);
+        answerOffset.erase(answerOffset.begin() + i);
+        answerLength.erase(answerLength.begin() + i);
+        tagsOffset.erase(tagsOffset.begin() + i);
+        tagsLength.erase(tagsLength.begin() + i);
+        ids.erase(ids.begin() + i);
+        compactIfNeeded();
+    }
 };
 
 class Flashcard {
 public:
     string title;
-    vector<Question> questions;
+    string tags;  // deck tags, apply to every question
+    QuestionStore questions;
+    bool damaged = false;  // loaded from a damaged file, so questions may be missing
     Flashcard() = default;
     Flashcard(const string& t) : title(t) {}
 };
@@ -105,12 +429,25 @@ public:
     T data;
     Node<T>* next;
     Node(const T& value) : data(value), next(nullptr) {}
+    Node(T&& value) : data(std::move(value)), next(nullptr) {}
 };
 
 template <typename T>
 class CircularLinkedList {
 private:
     Node<T>* tail;
+
+    void linkAtEnd(Node<T>* newNode) {
+        if (!tail) {
+            tail = newNode;
+            tail->next = tail;
+        } else {
+            newNode->next = tail->next;
+            tail->next = newNode;
+            tail = newNode;
+        }
+    }
+
 public:
     CircularLinkedList() : tail(nullptr) {}
 
@@ -149,15 +486,11 @@ public:
     Node<T>* getTail() const { return tail; }
 
     void insert(const T& value) {
-        Node<T>* newNode = new Node<T>(value);
-        if (!tail) {
-            tail = newNode;
-            tail->next = tail;
-        } else {
-            newNode->next = tail->next;
-            tail->next = newNode;
-            tail = newNode;
-        }
+        linkAtEnd(new Node<T>(value));
+    }
+
+    void insert(T&& value) {
+        linkAtEnd(new Node<T>(std::move(value)));
     }
 
     int getSize() const {
@@ -175,36 +508,1202 @@ public:
     bool removeAt(int index) {
         if (!tail || index < 1 || index > getSize()) return false;
 
-        Node<T>* toDelete;
-        if (tail->next == tail) {
-            // Only one node
-            toDelete = tail;
-            tail = nullptr;
-        } else {
-            // Find the node before the one to delete
-            Node<T>* prev = tail->next;
-            for (int i = 1; i < index - 1; ++i) {
-                prev = prev->next;
-            }
-            // If deleting the first node
-            if (index == 1) {
-                toDelete = tail->next;
-                tail->next = toDelete->next;
-            } else if (prev->next == tail) {
-                // Deleting the tail
-                toDelete = tail;
-                prev->next = tail->next;
-                tail = prev;
-            } else {
-                // Deleting a middle node
-                toDelete = prev->next;
-                prev->next = toDelete->next;
-            }
+        Node<T>* toDelete;
+        if (tail->next == tail) {
+            // Only one node
+            toDelete = tail;
+            tail = nullptr;
+        } else {
+            // Find the node before the one to delete
+            Node<T>* prev = tail->next;
+            for (int i = 1; i < index - 1; ++i) {
+                prev = prev->next;
+            }
+            // If deleting the first node
+            if (index == 1) {
+                toDelete = tail->next;
+                tail->next = toDelete->next;
+            } else if (prev->next == tail) {
+                // Deleting the tail
+                toDelete = tail;
+                prev->next = tail->next;
+                tail = prev;
+            } else {
+                // Deleting a middle node
+                toDelete = prev->next;
+                prev->next = toDelete->next;
+            }
+        }
+        delete toDelete;
+        return true;
+    }
+};
+
+//////////////////////////////////////////////////////////////
+// DECK COMPRESSION
+//////////////////////////////////////////////////////////////
+// Decks can be stored compressed with a built-in LZ77 codec, so no
+// external library is needed. A compressed deck file starts with the
+// 8-byte magic "\x89FCZ\r\n\x1A\n" (its first byte cannot start a text
+// deck, and line-ending conversion breaks it detectably) and is a series
+// of blocks, each holding
+//   uint32 rawSize, uint32 storedSize   (little endian)
+//   storedSize bytes: LZ sequences, or the raw text if storedSize == rawSize
+// A sequence is a token byte (literal count << 4 | match length - 4),
+// extra literal-count bytes if that nibble is 15, the literals, a 16-bit
+// little-endian match offset and extra match-length bytes if that nibble
+// is 15. The last sequence of a block has literals only.
+const char DECK_MAGIC[8] = { '\x89', 'F', 'C', 'Z', '\r', '\n', '\x1A', '\n' };
+const size_t DECK_BLOCK_SIZE = 1 << 18;
+const size_t LZ_MIN_MATCH = 4;
+const size_t LZ_MAX_OFFSET = 65535;
+const size_t LZ_DECODE_SLACK = 16;  // spare bytes for 8/16-byte wild copies
+
+void putLE32(string& out, uint32_t v) {
+    for (int i = 0; i < 4; ++i) out += (char)((v >> (8 * i)) & 0xFF);
+}
+
+uint32_t getLE32(const unsigned char* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+void lzWriteLength(string& out, size_t len) {
+    for (; len >= 255; len -= 255) out += (char)255;
+    out += (char)len;
+}
+
+void lzWriteSequence(string& out, const char* literals, size_t literalCount,
+                     size_t offset, size_t matchLength) {
+    size_t extraMatch = matchLength ? matchLength - LZ_MIN_MATCH : 0;
+    out += (char)((min<size_t>(literalCount, 15) << 4) | min<size_t>(extraMatch, 15));
+    if (literalCount >= 15) lzWriteLength(out, literalCount - 15);
+    out.append(literals, literalCount);
+    if (matchLength == 0) return;
+    out += (char)(offset & 0xFF);
+    out += (char)(offset >> 8);
+    if (extraMatch >= 15) lzWriteLength(out, extraMatch - 15);
+}
+
+// Compress src[0, n) and append the sequences to out. Level 1-9 sets how
+// many earlier positions with the same hash are tried per match: 1 at
+// level 1, doubling up to 256 at level 9.
+void lzCompressBlock(const char* src, size_t n, int level, string& out) {
+    const int HASH_BITS = 16;
+    const int maxAttempts = 1 << (min(max(level, 1), 9) - 1);
+    vector<int32_t> head(1 << HASH_BITS, -1);
+    vector<int32_t> prev(n);
+    auto hashAt = [&](size_t i) {
+        uint32_t v;
+        memcpy(&v, src + i, 4);
+        return (v * 2654435761u) >> (32 - HASH_BITS);
+    };
+    auto insert = [&](size_t i) {
+        uint32_t h = hashAt(i);
+        prev[i] = head[h];
+        head[h] = (int32_t)i;
+    };
+
+    size_t anchor = 0;
+    size_t i = 0;
+    while (i + LZ_MIN_MATCH <= n) {
+        size_t bestLength = 0, bestOffset = 0;
+        int32_t candidate = head[hashAt(i)];
+        for (int attempt = 0; candidate >= 0 && attempt < maxAttempts;
+             ++attempt, candidate = prev[candidate]) {
+            size_t offset = i - candidate;
+            if (offset > LZ_MAX_OFFSET) break;
+            // Cheap reject: a longer match must also agree at bestLength
+            if (src[candidate + bestLength] != src[i + bestLength] ||
+                memcmp(src + candidate, src + i, LZ_MIN_MATCH) != 0) continue;
+            size_t length = LZ_MIN_MATCH;
+            while (i + length < n && src[candidate + length] == src[i + length]) ++length;
+            if (length > bestLength) {
+                bestLength = length;
+                bestOffset = offset;
+                if (i + length == n) break;
+            }
+        }
+        insert(i);
+        if (bestLength < LZ_MIN_MATCH) {
+            ++i;
+            continue;
+        }
+
+        lzWriteSequence(out, src + anchor, i - anchor, bestOffset, bestLength);
+        for (size_t p = i + 1; p < i + bestLength && p + LZ_MIN_MATCH <= n; ++p) insert(p);
+        i += bestLength;
+        anchor = i;
+    }
+    lzWriteSequence(out, src + anchor, n - anchor, 0, 0);
+}
+
+// Decode one block of rawSize bytes into dst. dst must have room for
+// rawSize + LZ_DECODE_SLACK bytes: short copies are done 8 or 16 bytes at
+// a time and may write past the end of the block. Returns false if the
+// data is malformed.
+bool lzDecompressBlock(const unsigned char* ip, size_t n, char* dst, size_t rawSize) {
+    const unsigned char* end = ip + n;
+    size_t op = 0;
+    auto readLength = [&](size_t& length) {
+        unsigned char b;
+        do {
+            if (ip >= end) return false;
+            b = *ip++;
+            length += b;
+        } while (b == 255);
+        return true;
+    };
+
+    while (ip < end) {
+        unsigned token = *ip++;
+        size_t literals = token >> 4;
+        if (literals == 15 && !readLength(literals)) return false;
+        if ((size_t)(end - ip) < literals || rawSize - op < literals) return false;
+        if (literals <= 16 && end - ip >= 16) memcpy(dst + op, ip, 16);
+        else memcpy(dst + op, ip, literals);
+        ip += literals;
+        op += literals;
+        if (ip == end) break;
+
+        if (end - ip < 2) return false;
+        size_t offset = ip[0] | ((size_t)ip[1] << 8);
+        ip += 2;
+        size_t length = token & 15;
+        if (length == 15 && !readLength(length)) return false;
+        length += LZ_MIN_MATCH;
+        if (offset == 0 || offset > op || rawSize - op < length) return false;
+        if (offset >= 8) {
+            // Each 8-byte step reads only bytes that are already written
+            for (size_t k = 0; k < length; k += 8) {
+                memcpy(dst + op + k, dst + op - offset + k, 8);
+            }
+            op += length;
+        } else {
+            // Overlapping match repeats the last `offset` bytes
+            for (size_t k = 0; k < length; ++k, ++op) dst[op] = dst[op - offset];
+        }
+    }
+    return op == rawSize;
+}
+
+// Write a deck file as plain text (level 0) or compressed (levels 1-9)
+bool writeDeckFile(const string& path, const string& text, int level) {
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f) return false;
+    bool ok = true;
+    if (level <= 0) {
+        ok = fwrite(text.data(), 1, text.size(), f) == text.size();
+    } else {
+        string out(DECK_MAGIC, sizeof(DECK_MAGIC));
+        string packed;
+        for (size_t start = 0; start < text.size(); start += DECK_BLOCK_SIZE) {
+            size_t rawSize = min(DECK_BLOCK_SIZE, text.size() - start);
+            packed.clear();
+            lzCompressBlock(text.data() + start, rawSize, level, packed);
+            bool stored = packed.size() >= rawSize;
+            putLE32(out, (uint32_t)rawSize);
+            putLE32(out, (uint32_t)(stored ? rawSize : packed.size()));
+            if (stored) out.append(text, start, rawSize);
+            else out += packed;
+        }
+        ok = fwrite(out.data(), 1, out.size(), f) == out.size();
+    }
+    return fclose(f) == 0 && ok;
+}
+
+// Reads a deck file line by line, like getline(). Compressed files are
+// recognized by their magic header and decoded one block at a time, so
+// the text is never held in memory all at once.
+class DeckReader {
+private:
+    FILE* file = nullptr;
+    bool compressed = false;
+    bool damaged = false;
+    string buffer;  // current chunk of plain text
+    size_t pos = 0;
+    vector<unsigned char> stored;
+
+    bool fill() {
+        buffer.clear();
+        pos = 0;
+        if (!compressed) {
+            buffer.resize(DECK_BLOCK_SIZE);
+            buffer.resize(fread(&buffer[0], 1, DECK_BLOCK_SIZE, file));
+            return !buffer.empty();
+        }
+
+        unsigned char header[8];
+        size_t got = fread(header, 1, sizeof(header), file);
+        if (got == 0) return false;
+        uint32_t rawSize = got == sizeof(header) ? getLE32(header) : 0;
+        uint32_t storedSize = got == sizeof(header) ? getLE32(header + 4) : 0;
+        if (rawSize == 0 || rawSize > DECK_BLOCK_SIZE || storedSize > rawSize) {
+            damaged = true;
+            return false;
+        }
+        stored.resize(storedSize);
+        if (fread(stored.data(), 1, storedSize, file) != storedSize) {
+            damaged = true;
+            return false;
+        }
+        buffer.resize(rawSize + LZ_DECODE_SLACK);
+        if (storedSize == rawSize) {
+            memcpy(&buffer[0], stored.data(), rawSize);
+        } else if (!lzDecompressBlock(stored.data(), storedSize, &buffer[0], rawSize)) {
+            damaged = true;
+            buffer.clear();
+            return false;
+        }
+        buffer.resize(rawSize);
+        return true;
+    }
+
+public:
+    DeckReader() = default;
+    DeckReader(const DeckReader&) = delete;
+    DeckReader& operator=(const DeckReader&) = delete;
+    ~DeckReader() {
+        if (file) fclose(file);
+    }
+
+    bool open(const string& path) {
+        file = fopen(path.c_str(), "rb");
+        if (!file) return false;
+        char magic[sizeof(DECK_MAGIC)];
+        size_t got = fread(magic, 1, sizeof(magic), file);
+        if (got == sizeof(magic) && memcmp(magic, DECK_MAGIC, sizeof(magic)) == 0) {
+            compressed = true;
+        } else {
+            buffer.assign(magic, got);  // plain text: keep what was read
+        }
+        return true;
+    }
+
+    bool isDamaged() const { return damaged; }
+
+    // Files are read in binary mode, so a CRLF line ending (decks saved
+    // on Windows) is stripped here
+    bool readLine(string& line) {
+        line.clear();
+        bool found = false;
+        while (true) {
+            if (pos < buffer.size()) {
+                found = true;
+                size_t newline = buffer.find('\n', pos);
+                if (newline != string::npos) {
+                    line.append(buffer, pos, newline - pos);
+                    pos = newline + 1;
+                    break;
+                }
+                line.append(buffer, pos, string::npos);
+                pos = buffer.size();
+            }
+            if (!fill()) break;
+        }
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        return found;
+    }
+};
+
+//////////////////////////////////////////////////////////////
+// REVIEW HISTORY LOG
+//////////////////////////////////////////////////////////////
+// Every graded answer is appended to a binary, column-oriented log.
+// After an 8-byte header ("FCRL" + version) the file is a sequence of
+// blocks, each holding its events one column at a time:
+//   uint32 count
+//   uint32 timestamp[count]      seconds since epoch
+//   uint16 deckId[count]         line number in the deck dictionary
+//   uint32 questionId[count]     stable question id within the deck
+//   uint8  result[(count+7)/8]   one bit per event, 1 = correct
+// Values are stored in host byte order.
+struct LogBlock {
+    uint32_t count = 0;
+    const uint32_t* timestamp = nullptr;
+    const uint16_t* deckId = nullptr;
+    const uint32_t* questionId = nullptr;
+    const uint8_t* result = nullptr;
+
+    bool correct(uint32_t i) const { return (result[i >> 3] >> (i & 7)) & 1; }
+};
+
+// Per-question values of one deck, keyed by question id. Ids are sparse
+// (a deck file may name any id), so only small ids index a vector; the
+// rest go to a hash map. Small ids cover every deck that was never edited
+// and keep lookups during a log scan cheap.
+template <typename T>
+class QuestionIdTable {
+private:
+    static constexpr uint32_t DENSE_IDS = 65536;
+    vector<T> dense;
+    unordered_map<uint32_t, T> sparse;
+
+public:
+    bool empty() const { return dense.empty() && sparse.empty(); }
+
+    T& operator[](uint32_t id) {
+        if (id >= DENSE_IDS) return sparse[id];
+        if (id >= dense.size()) dense.resize(id + 1);
+        return dense[id];
+    }
+
+    // Returns nullptr if the id was never stored
+    const T* find(uint32_t id) const {
+        if (id < dense.size()) return &dense[id];
+        auto it = sparse.find(id);
+        return it == sparse.end() ? nullptr : &it->second;
+    }
+};
+
+struct DeckStats {
+    uint64_t attempts = 0;
+    uint64_t correct = 0;
+    uint32_t currentStreak = 0;
+    uint32_t bestStreak = 0;
+    // Trend windows: the last 7 days and the 7 days before that
+    uint64_t recentAttempts = 0;
+    uint64_t recentCorrect = 0;
+    uint64_t priorAttempts = 0;
+    uint64_t priorCorrect = 0;
+};
+
+struct QuestionStats {
+    uint32_t attempts = 0;
+    uint32_t correct = 0;
+};
+
+struct ReviewStats {
+    uint64_t totalEvents = 0;
+    vector<DeckStats> decks;                  // indexed by deck id
+    vector<QuestionIdTable<QuestionStats>> questions;  // [deck id][question id]
+};
+
+class ReviewLog {
+private:
+    static constexpr uint32_t MAGIC = 0x4C524346;  // "FCRL"
+    static constexpr uint32_t VERSION = 1;
+    static constexpr uint32_t MAX_BLOCK = 65536;
+
+    string logPath;
+    string dictPath;
+    vector<string> deckNames;
+    unordered_map<string, uint16_t> deckIds;
+    bool dictLoaded = false;
+
+    // Events waiting to be written as the next block
+    vector<uint32_t> pendingTime;
+    vector<uint16_t> pendingDeck;
+    vector<uint32_t> pendingQuestion;
+    vector<uint8_t> pendingResult;
+
+    // Size of the log up to its last complete block, or -1 if not checked
+    long validSize = -1;
+
+    static long blockBytes(uint32_t count) {
+        return (long)sizeof(count) + (long)count * (2 * sizeof(uint32_t) + sizeof(uint16_t))
+             + (long)(count + 7) / 8;
+    }
+
+    // Before appending, make sure the log ends with a complete block: a
+    // write cut short (disk full, crash) leaves a partial block that would
+    // make everything appended after it unreadable, so it is cut off.
+    // Returns false if the log cannot be appended to safely.
+    bool checkTail() {
+        struct stat info;
+        if (stat(logPath.c_str(), &info) != 0) {
+            validSize = 0;
+            return true;
+        }
+        long size = (long)info.st_size;
+        if (size == validSize) return true;
+
+        FILE* f = fopen(logPath.c_str(), "rb");
+        if (!f) return false;
+        long end = 0;
+        uint32_t header[2];
+        if (fread(header, sizeof(header), 1, f) == 1) {
+            if (header[0] != MAGIC || header[1] != VERSION) {
+                fclose(f);
+                return false;
+            }
+            end = sizeof(header);
+            uint32_t count;
+            while (fread(&count, sizeof(count), 1, f) == 1) {
+                if (count == 0 || count > MAX_BLOCK) {
+                    fclose(f);  // damaged before the tail; leave it alone
+                    return false;
+                }
+                if (end + blockBytes(count) > size) break;
+                end += blockBytes(count);
+                if (fseek(f, end, SEEK_SET) != 0) break;
+            }
+        }
+        fclose(f);
+        if (end < size && !truncateFileFs(logPath, end)) return false;
+        validSize = end;
+        return true;
+    }
+
+    void loadDictionary() {
+        if (dictLoaded) return;
+        dictLoaded = true;
+        ifstream in(dictPath);
+        string name;
+        while (getline(in, name)) {
+            if (!name.empty()) deckIds.emplace(name, (uint16_t)deckNames.size());
+            deckNames.push_back(name);
+        }
+    }
+
+    void saveDictionary() const {
+        ofstream out(dictPath, ios::trunc);
+        for (const string& name : deckNames) out << name << "\n";
+    }
+
+public:
+    ReviewLog(const string& folder)
+        : logPath(folder + "/review_history.dat"),
+          dictPath(folder + "/review_decks.dat") {}
+
+    ~ReviewLog() { flush(); }
+
+    const vector<string>& getDeckNames() {
+        loadDictionary();
+        return deckNames;
+    }
+
+    // Returns the id of a deck title, registering it if it is new
+    int deckId(const string& title) {
+        loadDictionary();
+        auto it = deckIds.find(title);
+        if (it != deckIds.end()) return it->second;
+        if (deckNames.size() > UINT16_MAX) return -1;
+        uint16_t id = (uint16_t)deckNames.size();
+        deckNames.push_back(title);
+        deckIds.emplace(title, id);
+        ofstream out(dictPath, ios::app);
+        out << title << "\n";
+        return id;
+    }
+
+    // Detach a title from its history, e.g. when the deck is deleted, so a
+    // later deck with the same title starts fresh. The id stays reserved;
+    // its dictionary line becomes empty.
+    void retireDeck(const string& title) {
+        loadDictionary();
+        auto it = deckIds.find(title);
+        if (it == deckIds.end()) return;
+        deckNames[it->second].clear();
+        deckIds.erase(it);
+        saveDictionary();
+    }
+
+    // Keep a deck's history attached to it when its title changes. Any
+    // stale history left under the new title is retired first.
+    void renameDeck(const string& oldTitle, const string& newTitle) {
+        loadDictionary();
+        if (deckIds.count(newTitle)) retireDeck(newTitle);
+        auto it = deckIds.find(oldTitle);
+        if (it == deckIds.end()) return;
+        uint16_t id = it->second;
+        deckIds.erase(it);
+        deckIds.emplace(newTitle, id);
+        deckNames[id] = newTitle;
+        saveDictionary();
+    }
+
+    void record(const string& deckTitle, uint32_t questionId, bool correct) {
+        int id = deckId(deckTitle);
+        if (id < 0) return;
+        size_t n = pendingTime.size();
+        if (n % 8 == 0) pendingResult.push_back(0);
+        if (correct) pendingResult.back() |= (uint8_t)(1 << (n % 8));
+        pendingTime.push_back((uint32_t)time(0));
+        pendingDeck.push_back((uint16_t)id);
+        pendingQuestion.push_back(questionId);
+        if (pendingTime.size() >= MAX_BLOCK) flush();
+    }
+
+    // Append all pending events to the log, in blocks of at most
+    // MAX_BLOCK. If anything fails the log is cut back to where it was and
+    // the events stay pending, so the next flush tries again.
+    bool flush() {
+        if (pendingTime.empty()) return true;
+        if (!checkTail()) return false;
+        FILE* f = fopen(logPath.c_str(), "ab");
+        if (!f) return false;
+        bool ok = true;
+        long size = validSize;
+        if (size == 0) {
+            uint32_t header[2] = { MAGIC, VERSION };
+            ok = fwrite(header, sizeof(header), 1, f) == 1;
+            size = sizeof(header);
+        }
+        // MAX_BLOCK is a multiple of 8, so each block starts on a result byte
+        for (size_t first = 0; ok && first < pendingTime.size(); first += MAX_BLOCK) {
+            uint32_t count = (uint32_t)min<size_t>(pendingTime.size() - first, MAX_BLOCK);
+            size_t resBytes = (count + 7) / 8;
+            ok = fwrite(&count, sizeof(count), 1, f) == 1 &&
+                 fwrite(pendingTime.data() + first, sizeof(uint32_t), count, f) == count &&
+                 fwrite(pendingDeck.data() + first, sizeof(uint16_t), count, f) == count &&
+                 fwrite(pendingQuestion.data() + first, sizeof(uint32_t), count, f) == count &&
+                 fwrite(pendingResult.data() + first / 8, 1, resBytes, f) == resBytes;
+            size += blockBytes(count);
+        }
+        ok = fclose(f) == 0 && ok;
+        if (!ok) {
+            if (!truncateFileFs(logPath, validSize)) validSize = -1;
+            return false;
+        }
+        validSize = size;
+        pendingTime.clear();
+        pendingDeck.clear();
+        pendingQuestion.clear();
+        pendingResult.clear();
+        return true;
+    }
+
+    // Call visit() once per block, with the columns read into reusable
+    // buffers. Returns false if the log is missing or damaged.
+    bool forEachBlock(const function<void(const LogBlock&)>& visit) {
+        flush();
+        FILE* f = fopen(logPath.c_str(), "rb");
+        if (!f) return false;
+        setvbuf(f, nullptr, _IOFBF, 1 << 20);
+
+        uint32_t header[2];
+        if (fread(header, sizeof(header), 1, f) != 1 ||
+            header[0] != MAGIC || header[1] != VERSION) {
+            fclose(f);
+            return false;
+        }
+
+        vector<uint32_t> ts, qid;
+        vector<uint16_t> deck;
+        vector<uint8_t> res;
+        bool ok = true;
+        uint32_t count;
+        while (fread(&count, sizeof(count), 1, f) == 1) {
+            if (count == 0 || count > MAX_BLOCK) { ok = false; break; }
+            if (ts.size() < count) {
+                ts.resize(count);
+                deck.resize(count);
+                qid.resize(count);
+                res.resize((count + 7) / 8);
+            }
+            size_t resBytes = (count + 7) / 8;
+            if (fread(ts.data(), sizeof(uint32_t), count, f) != count ||
+                fread(deck.data(), sizeof(uint16_t), count, f) != count ||
+                fread(qid.data(), sizeof(uint32_t), count, f) != count ||
+                fread(res.data(), 1, resBytes, f) != resBytes) {
+                ok = false;
+                break;
+            }
+            LogBlock block;
+            block.count = count;
+            block.timestamp = ts.data();
+            block.deckId = deck.data();
+            block.questionId = qid.data();
+            block.result = res.data();
+            visit(block);
+        }
+        fclose(f);
+        return ok;
+    }
+
+    bool computeStats(ReviewStats& stats) {
+        const uint32_t now = (uint32_t)time(0);
+        const uint32_t week = 7 * 24 * 60 * 60;
+        const uint32_t recentStart = now > week ? now - week : 0;
+        const uint32_t priorStart = now > 2 * week ? now - 2 * week : 0;
+
+        stats = ReviewStats();
+        stats.decks.resize(getDeckNames().size());
+        stats.questions.resize(stats.decks.size());
+
+        return forEachBlock([&](const LogBlock& b) {
+            stats.totalEvents += b.count;
+            for (uint32_t i = 0; i < b.count; ++i) {
+                uint16_t d = b.deckId[i];
+                if (d >= stats.decks.size()) {
+                    stats.decks.resize(d + 1);
+                    stats.questions.resize(d + 1);
+                }
+                bool ok = b.correct(i);
+                DeckStats& ds = stats.decks[d];
+                ds.attempts++;
+                if (ok) {
+                    ds.correct++;
+                    ds.currentStreak++;
+                    if (ds.currentStreak > ds.bestStreak) ds.bestStreak = ds.currentStreak;
+                } else {
+                    ds.currentStreak = 0;
+                }
+
+                uint32_t t = b.timestamp[i];
+                if (t >= recentStart) {
+                    ds.recentAttempts++;
+                    ds.recentCorrect += ok;
+                } else if (t >= priorStart) {
+                    ds.priorAttempts++;
+                    ds.priorCorrect += ok;
+                }
+
+                QuestionStats& qs = stats.questions[d][b.questionId[i]];
+                qs.attempts++;
+                qs.correct += ok;
+            }
+        });
+    }
+};
+
+//////////////////////////////////////////////////////////////
+// TAG INDEX
+//////////////////////////////////////////////////////////////
+inline int popcount64(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(x);
+#else
+    int n = 0;
+    for (; x; x &= x - 1) ++n;
+    return n;
+#endif
+}
+
+inline int trailingZeros64(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(x);
+#else
+    int n = 0;
+    for (; !(x & 1); x >>= 1) ++n;
+    return n;
+#endif
+}
+
+// Compressed set of 32-bit ids in the style of Roaring bitmaps. Ids are
+// grouped by their high 16 bits; each group keeps its low 16 bits either
+// as a sorted array (up to 4096 ids) or as a 65536-bit bitmap.
+class RoaringBitmap {
+private:
+    static constexpr uint32_t ARRAY_MAX = 4096;
+    static constexpr size_t WORDS = 65536 / 64;
+
+    struct Container {
+        vector<uint16_t> array;  // sorted values while sparse
+        vector<uint64_t> bits;   // WORDS words once dense
+        uint32_t cardinality = 0;
+
+        bool isBitmap() const { return !bits.empty(); }
+        bool contains(uint16_t v) const {
+            if (isBitmap()) return (bits[v >> 6] >> (v & 63)) & 1;
+            return binary_search(array.begin(), array.end(), v);
+        }
+    };
+
+    enum class Op { AND, OR, ANDNOT };
+
+    vector<uint16_t> keys;  // sorted high halves
+    vector<Container> containers;
+
+    static void toBitmap(Container& c) {
+        c.bits.assign(WORDS, 0);
+        for (uint16_t v : c.array) c.bits[v >> 6] |= 1ULL << (v & 63);
+        vector<uint16_t>().swap(c.array);
+    }
+
+    static void toArrayIfSparse(Container& c) {
+        if (!c.isBitmap() || c.cardinality > ARRAY_MAX) return;
+        c.array.reserve(c.cardinality);
+        for (size_t w = 0; w < WORDS; ++w) {
+            for (uint64_t word = c.bits[w]; word; word &= word - 1) {
+                c.array.push_back((uint16_t)(w * 64 + trailingZeros64(word)));
+            }
+        }
+        vector<uint64_t>().swap(c.bits);
+    }
+
+    static Container combine(const Container& a, const Container& b, Op op) {
+        Container out;
+        if (!a.isBitmap() && !b.isBitmap()) {
+            auto into = back_inserter(out.array);
+            const auto& x = a.array;
+            const auto& y = b.array;
+            if (op == Op::AND) set_intersection(x.begin(), x.end(), y.begin(), y.end(), into);
+            else if (op == Op::OR) set_union(x.begin(), x.end(), y.begin(), y.end(), into);
+            else set_difference(x.begin(), x.end(), y.begin(), y.end(), into);
+            out.cardinality = (uint32_t)out.array.size();
+            if (out.cardinality > ARRAY_MAX) toBitmap(out);
+            return out;
+        }
+
+        // A sparse side only needs membership tests against the other one
+        const Container* filter = nullptr;
+        const Container* against = nullptr;
+        if (op != Op::OR && !a.isBitmap()) { filter = &a; against = &b; }
+        else if (op == Op::AND && !b.isBitmap()) { filter = &b; against = &a; }
+        if (filter) {
+            bool keepIfPresent = (op == Op::AND);
+            for (uint16_t v : filter->array) {
+                if (against->contains(v) == keepIfPresent) out.array.push_back(v);
+            }
+            out.cardinality = (uint32_t)out.array.size();
+            return out;
+        }
+
+        Container da, db;
+        if (!a.isBitmap()) { da = a; toBitmap(da); }
+        if (!b.isBitmap()) { db = b; toBitmap(db); }
+        const vector<uint64_t>& wa = a.isBitmap() ? a.bits : da.bits;
+        const vector<uint64_t>& wb = b.isBitmap() ? b.bits : db.bits;
+        out.bits.resize(WORDS);
+        for (size_t w = 0; w < WORDS; ++w) {
+            uint64_t word = op == Op::AND ? (wa[w] & wb[w])
+                          : op == Op::OR  ? (wa[w] | wb[w])
+                          : (wa[w] & ~wb[w]);
+            out.bits[w] = word;
+            out.cardinality += popcount64(word);
+        }
+        toArrayIfSparse(out);
+        return out;
+    }
+
+    RoaringBitmap combineWith(const RoaringBitmap& other, Op op) const {
+        RoaringBitmap out;
+        size_t i = 0, j = 0;
+        while (i < keys.size() || j < other.keys.size()) {
+            if (j == other.keys.size() || (i < keys.size() && keys[i] < other.keys[j])) {
+                if (op != Op::AND) {
+                    out.keys.push_back(keys[i]);
+                    out.containers.push_back(containers[i]);
+                }
+                ++i;
+            } else if (i == keys.size() || other.keys[j] < keys[i]) {
+                if (op == Op::OR) {
+                    out.keys.push_back(other.keys[j]);
+                    out.containers.push_back(other.containers[j]);
+                }
+                ++j;
+            } else {
+                Container c = combine(containers[i], other.containers[j], op);
+                if (c.cardinality > 0) {
+                    out.keys.push_back(keys[i]);
+                    out.containers.push_back(std::move(c));
+                }
+                ++i;
+                ++j;
+            }
+        }
+        return out;
+    }
+
+public:
+    // Adding ids in increasing order is the fast path used by the index
+    void add(uint32_t id) {
+        uint16_t high = (uint16_t)(id >> 16);
+        uint16_t low = (uint16_t)(id & 0xFFFF);
+        size_t pos = keys.size();
+        if (keys.empty() || keys.back() != high) {
+            pos = lower_bound(keys.begin(), keys.end(), high) - keys.begin();
+            if (pos == keys.size() || keys[pos] != high) {
+                keys.insert(keys.begin() + pos, high);
+                containers.insert(containers.begin() + pos, Container());
+            }
+        } else {
+            pos = keys.size() - 1;
+        }
+
+        Container& c = containers[pos];
+        if (c.isBitmap()) {
+            uint64_t mask = 1ULL << (low & 63);
+            if (!(c.bits[low >> 6] & mask)) {
+                c.bits[low >> 6] |= mask;
+                c.cardinality++;
+            }
+            return;
+        }
+        if (c.array.empty() || c.array.back() < low) {
+            c.array.push_back(low);
+        } else {
+            auto it = lower_bound(c.array.begin(), c.array.end(), low);
+            if (*it == low) return;
+            c.array.insert(it, low);
+        }
+        if (++c.cardinality > ARRAY_MAX) toBitmap(c);
+    }
+
+    size_t cardinality() const {
+        size_t total = 0;
+        for (const Container& c : containers) total += c.cardinality;
+        return total;
+    }
+
+    bool empty() const { return keys.empty(); }
+
+    RoaringBitmap operator&(const RoaringBitmap& other) const { return combineWith(other, Op::AND); }
+    RoaringBitmap operator|(const RoaringBitmap& other) const { return combineWith(other, Op::OR); }
+    RoaringBitmap andNot(const RoaringBitmap& other) const { return combineWith(other, Op::ANDNOT); }
+
+    // Call visit(id) for every id in increasing order
+    template <typename Visit>
+    void forEach(Visit visit) const {
+        for (size_t k = 0; k < keys.size(); ++k) {
+            uint32_t base = (uint32_t)keys[k] << 16;
+            const Container& c = containers[k];
+            if (!c.isBitmap()) {
+                for (uint16_t v : c.array) visit(base | v);
+                continue;
+            }
+            for (size_t w = 0; w < WORDS; ++w) {
+                for (uint64_t word = c.bits[w]; word; word &= word - 1) {
+                    visit(base | (uint32_t)(w * 64 + trailingZeros64(word)));
+                }
+            }
+        }
+    }
+};
+
+// Maps every tag to the bitmap of questions carrying it, either directly
+// or through their deck's tags. Question ids number all questions of all
+// loaded decks in list order.
+class TagIndex {
+private:
+    static bool isOperator(const string& token, const char* name) {
+        if (token.size() != strlen(name)) return false;
+        for (size_t i = 0; i < token.size(); ++i) {
+            if (toupper((unsigned char)token[i]) != name[i]) return false;
+        }
+        return true;
+    }
+
+    bool parseOr(const vector<string>& tokens, size_t& pos, RoaringBitmap& out, string& error) const {
+        if (!parseAnd(tokens, pos, out, error)) return false;
+        while (pos < tokens.size() && isOperator(tokens[pos], "OR")) {
+            ++pos;
+            RoaringBitmap rhs;
+            if (!parseAnd(tokens, pos, rhs, error)) return false;
+            out = out | rhs;
+        }
+        return true;
+    }
+
+    // AND and binary NOT (and-not) bind tighter than OR
+    bool parseAnd(const vector<string>& tokens, size_t& pos, RoaringBitmap& out, string& error) const {
+        if (!parseFactor(tokens, pos, out, error)) return false;
+        while (pos < tokens.size() &&
+               (isOperator(tokens[pos], "AND") || isOperator(tokens[pos], "NOT"))) {
+            bool andNot = isOperator(tokens[pos], "NOT");
+            ++pos;
+            RoaringBitmap rhs;
+            if (!parseFactor(tokens, pos, rhs, error)) return false;
+            out = andNot ? out.andNot(rhs) : out & rhs;
+        }
+        return true;
+    }
+
+    bool parseFactor(const vector<string>& tokens, size_t& pos, RoaringBitmap& out, string& error) const {
+        if (pos >= tokens.size()) {
+            error = "Unexpected end of query.";
+            return false;
+        }
+        const string& token = tokens[pos++];
+        if (isOperator(token, "NOT")) {
+            RoaringBitmap rhs;
+            if (!parseFactor(tokens, pos, rhs, error)) return false;
+            out = all.andNot(rhs);
+            return true;
+        }
+        if (token == "(") {
+            if (!parseOr(tokens, pos, out, error)) return false;
+            if (pos >= tokens.size() || tokens[pos] != ")") {
+                error = "Missing ')'.";
+                return false;
+            }
+            ++pos;
+            return true;
+        }
+        if (token == ")" || isOperator(token, "AND") || isOperator(token, "OR")) {
+            error = "Unexpected '" + token + "'.";
+            return false;
+        }
+        auto it = byTag.find(normalizeTags(token));
+        out = it != byTag.end() ? it->second : RoaringBitmap();
+        return true;
+    }
+
+public:
+    vector<Flashcard*> deckOf;     // [question id]
+    vector<uint32_t> indexInDeck;  // [question id]
+    unordered_map<string, RoaringBitmap> byTag;
+    RoaringBitmap all;
+
+    void build(const CircularLinkedList<Flashcard>& cards) {
+        deckOf.clear();
+        indexInDeck.clear();
+        byTag.clear();
+        all = RoaringBitmap();
+        if (cards.isEmpty()) return;
+
+        Node<Flashcard>* curr = cards.getHead();
+        do {
+            Flashcard& fc = curr->data;
+            for (size_t i = 0; i < fc.questions.size(); ++i) {
+                uint32_t id = (uint32_t)deckOf.size();
+                deckOf.push_back(&fc);
+                indexInDeck.push_back((uint32_t)i);
+                all.add(id);
+                auto addTag = [&](string_view tag) { byTag[string(tag)].add(id); };
+                forEachTag(fc.tags, addTag);
+                forEachTag(fc.questions.tags(i), addTag);
+            }
+            curr = curr->next;
+        } while (curr != cards.getHead());
+    }
+
+    // Evaluate a query such as "(networking AND os) NOT easy". Operators
+    // are AND, OR and NOT (unary, or binary meaning "and not"), with
+    // parentheses for grouping. Unknown tags match nothing.
+    bool query(const string& text, RoaringBitmap& result, string& error) const {
+        vector<string> tokens;
+        string current;
+        for (size_t i = 0; i <= text.size(); ++i) {
+            char c = i < text.size() ? text[i] : ' ';
+            if (isspace((unsigned char)c) || c == '(' || c == ')') {
+                if (!current.empty()) tokens.push_back(current);
+                current.clear();
+                if (c == '(' || c == ')') tokens.push_back(string(1, c));
+            } else {
+                current += c;
+            }
+        }
+        if (tokens.empty()) {
+            error = "Query is empty.";
+            return false;
+        }
+
+        size_t pos = 0;
+        if (!parseOr(tokens, pos, result, error)) return false;
+        if (pos < tokens.size()) {
+            error = "Expected AND, OR or NOT before '" + tokens[pos] + "'.";
+            return false;
+        }
+        return true;
+    }
+};
+
+//////////////////////////////////////////////////////////////
+// WEIGHTED SAMPLING
+//////////////////////////////////////////////////////////////
+// Walker/Vose alias table. Building is O(n); each draw then picks a
+// column uniformly and returns either that column or its alias, so a
+// sample costs O(1) however skewed the weights are.
+class AliasTable {
+private:
+    // Probability and alias share a column so a draw touches one cache line
+    struct Column {
+        double probability;
+        uint32_t alias;
+    };
+    vector<Column> columns;
+    vector<uint32_t> small, large;  // work lists, kept to reuse capacity
+
+public:
+    size_t size() const { return columns.size(); }
+
+    void build(const vector<double>& weights) {
+        size_t n = weights.size();
+        columns.resize(n);
+        if (n == 0) return;
+
+        double total = 0;
+        for (double w : weights) total += w;
+
+        // Scale so the average weight is 1, then pair each light column
+        // with a heavy one that tops it up
+        small.clear();
+        large.clear();
+        for (size_t i = 0; i < n; ++i) {
+            columns[i].probability = total > 0 ? weights[i] * n / total : 1.0;
+            (columns[i].probability < 1.0 ? small : large).push_back((uint32_t)i);
+        }
+        while (!small.empty() && !large.empty()) {
+            uint32_t s = small.back();
+            small.pop_back();
+            uint32_t l = large.back();
+            columns[s].alias = l;
+            columns[l].probability = (columns[l].probability + columns[s].probability) - 1.0;
+            if (columns[l].probability < 1.0) {
+                large.pop_back();
+                small.push_back(l);
+            }
+        }
+        // Whatever is left is 1 up to rounding error
+        for (uint32_t i : large) columns[i] = { 1.0, i };
+        for (uint32_t i : small) columns[i] = { 1.0, i };
+    }
+
+    // One 64-bit draw: the high half picks the column, the low half is
+    // the biased coin
+    template <typename Rng>
+    uint32_t sample(Rng& rng) const {
+        uint64_t r = rng();
+        const Column& c = columns[((r >> 32) * columns.size()) >> 32];
+        double coin = (uint32_t)r * (1.0 / 4294967296.0);
+        return coin < c.probability ? (uint32_t)(&c - columns.data()) : c.alias;
+    }
+};
+
+// Benchmark for "--bench-alias [cards]": rebuild time and draw rate for a
+// table of random drill weights, plus a check that draw frequencies match
+// the weights. Uses a fixed seed so runs are comparable.
+int benchAlias(size_t cardCount) {
+    using Clock = chrono::steady_clock;
+    auto msSince = [](Clock::time_point start) {
+        return chrono::duration<double, milli>(Clock::now() - start).count();
+    };
+    mt19937_64 rng(12345);
+    uniform_real_distribution<double> rate(0.0, 1.0);
+    vector<double> weights(cardCount);
+    for (double& w : weights) w = 0.05 + rate(rng);
+
+    AliasTable table;
+    table.build(weights);  // first build allocates; time the rebuilds
+    const int builds = 10;
+    auto start = Clock::now();
+    for (int i = 0; i < builds; ++i) table.build(weights);
+    double buildMs = msSince(start) / builds;
+
+    const uint64_t draws = 10000000;
+    uint64_t checksum = 0;
+    start = Clock::now();
+    for (uint64_t i = 0; i < draws; ++i) checksum += table.sample(rng);
+    double drawMs = msSince(start);
+    volatile uint64_t sink = checksum;  // keeps the draws from being optimized out
+    (void)sink;
+
+    const vector<double> small = { 1, 2, 3, 4, 5, 15 };
+    AliasTable check;
+    check.build(small);
+    vector<uint64_t> hits(small.size());
+    for (uint64_t i = 0; i < draws; ++i) hits[check.sample(rng)]++;
+    double maxError = 0;
+    for (size_t i = 0; i < small.size(); ++i) {
+        maxError = max(maxError, fabs((double)hits[i] / draws - small[i] / 30.0));
+    }
+
+    cout << fixed << setprecision(2);
+    cout << "Alias table, " << cardCount << " cards\n";
+    cout << "  rebuild:  " << buildMs << " ms (average of " << builds << ")\n";
+    cout << "  draws:    " << draws / drawMs / 1000.0 << "M/s ("
+         << drawMs * 1e6 / draws << " ns each)\n";
+    cout << "  accuracy: " << draws << " draws over " << small.size()
+         << " weights, max deviation " << maxError * 100 << "%\n";
+    return 0;
+}
+
+//////////////////////////////////////////////////////////////
+// EXPORT FORMATS
+//////////////////////////////////////////////////////////////
+enum class ExportFormat { CSV, JSONL, ANKI };
+
+const char* exportExtension(ExportFormat format) {
+    switch (format) {
+        case ExportFormat::CSV:   return ".csv";
+        case ExportFormat::JSONL: return ".jsonl";
+        default:                  return ".tsv";
+    }
+}
+
+// Quote a field if it contains the separator, a quote or a line break
+// (RFC 4180; Anki's plain-text importer uses the same rule with tabs)
+void appendQuotedField(string& out, string_view field, char separator) {
+    const char specials[] = { '"', '\r', '\n', separator, '\0' };
+    if (field.find_first_of(specials) == string_view::npos) {
+        out += field;
+        return;
+    }
+    out += '"';
+    for (char c : field) {
+        if (c == '"') out += '"';
+        out += c;
+    }
+    out += '"';
+}
+
+void appendJsonString(string& out, string_view value) {
+    static const char hex[] = "0123456789abcdef";
+    out += '"';
+    for (unsigned char c : value) {
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n";  break;
+            case '\r': out += "\\r";  break;
+            case '\t': out += "\\t";  break;
+            default:
+                if (c < 0x20) {
+                    out += "\\u00";
+                    out += hex[c >> 4];
+                    out += hex[c & 0xF];
+                } else {
+                    out += (char)c;
+                }
+        }
+    }
+    out += '"';
+}
+
+// Header written once at the top of an export file. Combined Anki files
+// carry the deck name in a third column; per-deck files name the deck.
+string exportHeader(ExportFormat format, const string& deckTitle, bool combined) {
+    switch (format) {
+        case ExportFormat::CSV:
+            return "deck,question,answer\n";
+        case ExportFormat::JSONL:
+            return "";
+        default: {
+            string header = "#separator:tab\n#html:false\n";
+            if (combined) header += "#deck column:3\n";
+            else header += "#deck:" + deckTitle + "\n";
+            return header;
+        }
+    }
+}
+
+// Append every question of a deck to out, one record per line
+void serializeDeck(const Flashcard& fc, ExportFormat format, bool combined, string& out) {
+    for (size_t i = 0; i < fc.questions.size(); ++i) {
+        string_view question = fc.questions.question(i);
+        string_view answer = fc.questions.answer(i);
+        switch (format) {
+            case ExportFormat::CSV:
+                appendQuotedField(out, fc.title, ',');
+                out += ',';
+                appendQuotedField(out, question, ',');
+                out += ',';
+                appendQuotedField(out, answer, ',');
+                break;
+            case ExportFormat::JSONL:
+                out += "{\"deck\":";
+                appendJsonString(out, fc.title);
+                out += ",\"question\":";
+                appendJsonString(out, question);
+                out += ",\"answer\":";
+                appendJsonString(out, answer);
+                out += '}';
+                break;
+            case ExportFormat::ANKI:
+                appendQuotedField(out, question, '\t');
+                out += '\t';
+                appendQuotedField(out, answer, '\t');
+                if (combined) {
+                    out += '\t';
+                    appendQuotedField(out, fc.title, '\t');
+                }
+                break;
         }
-        delete toDelete;
-        return true;
+        out += '\n';
     }
-};
+}
 
 //////////////////////////////////////////////////////////////
 // FLASHCARD MANAGER
@@ -212,7 +1711,35 @@ public:
 class FlashcardManager {
 private:
     CircularLinkedList<Flashcard> cards;
-    const string folderName = "flashcards";
+    const string folderName;
+    const string exportFolderName = "exports";
+    const string settingsFile = folderName + "/settings.cfg";
+    int compressionLevel = 0;  // 0 = plain text, 1-9 = built-in codec
+    ReviewLog reviewLog{folderName};
+    TagIndex tagIndex;
+    bool tagIndexDirty = true;
+
+    // Drill mode: a card's weight is a floor plus its recent error rate,
+    // an exponential moving average that starts at the prior for unseen
+    // cards. The alias table is rebuilt after every batch of answers.
+    static constexpr double DRILL_ALPHA = 0.3;
+    static constexpr double DRILL_PRIOR_ERROR = 0.5;
+    static constexpr double DRILL_MIN_WEIGHT = 0.05;
+    static constexpr int DRILL_REBUILD_BATCH = 5;
+
+    static void updateErrorRate(double& rate, bool wrong) {
+        rate = rate * (1.0 - DRILL_ALPHA) + (wrong ? DRILL_ALPHA : 0.0);
+    }
+
+    // Write graded answers to the review history; they stay pending if
+    // that fails, and the next save tries again
+    void saveReviewHistory() {
+        if (!reviewLog.flush()) {
+            cout << "Warning: could not save your answers to " << folderName
+                 << "/review_history.dat (disk full or file damaged?). "
+                 << "They will be saved with your next review if possible.\n";
+        }
+    }
 
     bool titleExistsInMemory(const string& title, const string& excludeTitle = "") const {
         if (cards.isEmpty()) return false;
@@ -225,23 +1752,75 @@ private:
         return false;
     }
 
+    Flashcard* findByTitle(const string& title) const {
+        if (cards.isEmpty()) return nullptr;
+        Node<Flashcard>* curr = cards.getHead();
+        do {
+            if (curr->data.title == title) return &curr->data;
+            curr = curr->next;
+        } while (curr != cards.getHead());
+        return nullptr;
+    }
+
     void saveToFile(const Flashcard& fc) const {
+        if (fc.damaged) {
+            cout << "Not saved: \"" << fc.title << "\" was loaded from a damaged file, "
+                 << "and saving would replace it with only the questions that could be read.\n";
+            return;
+        }
         if (!dirExists(folderName)) {
             createDir(folderName);
         }
         string filename = folderName + "/" + fc.title + ".txt";
-        ofstream outputFile(filename);
-        if (!outputFile) {
+        string text;
+        if (!fc.tags.empty()) {
+            text += "#tags: " + fc.tags + "\n";
+        }
+        // Question ids are implied by position and only written where they
+        // break the sequence, so a deck that was never edited has none. The
+        // next id is kept too, so ids of deleted questions are not reused.
+        uint32_t impliedId = 0;
+        for (size_t i = 0; i < fc.questions.size(); ++i) {
+            impliedId = max(impliedId, fc.questions.id(i) + 1);
+        }
+        if (fc.questions.getNextId() > impliedId) {
+            text += "#next-id: " + to_string(fc.questions.getNextId()) + "\n";
+        }
+        impliedId = 0;
+        for (size_t i = 0; i < fc.questions.size(); ++i) {
+            uint32_t id = fc.questions.id(i);
+            appendQuestionLine(text, fc.questions.question(i), fc.questions.answer(i),
+                               fc.questions.tags(i), id, id != impliedId);
+            impliedId = max(impliedId, id + 1);
+        }
+        if (!writeDeckFile(filename, text, compressionLevel)) {
             cout << "Error saving file!\n";
             return;
         }
-        for (const auto& q : fc.questions) {
-            outputFile << q.question << "|" << q.answer << "\n";
-        }
-        outputFile.close();
         cout << "Saved to " << filename << "\n";
     }
 
+    // Settings are "key=value" lines; unknown keys are ignored
+    void loadSettings() {
+        ifstream in(settingsFile);
+        string line;
+        while (getline(in, line)) {
+            size_t eq = line.find('=');
+            if (eq == string::npos) continue;
+            if (line.substr(0, eq) == "compression") {
+                compressionLevel = min(max(atoi(line.c_str() + eq + 1), 0), 9);
+            }
+        }
+    }
+
+    void saveSettings() const {
+        if (!dirExists(folderName)) {
+            createDir(folderName);
+        }
+        ofstream out(settingsFile, ios::trunc);
+        out << "compression=" << compressionLevel << "\n";
+    }
+
     void deleteFile(const string& title) const {
         string filename = folderName + "/" + title + ".txt";
         if (fileExists(filename)) {
@@ -249,10 +1828,11 @@ private:
         }
     }
 
-    void printQuestionBox(const Question& q, int qnum) const {
+    // Returns true if the user marked the answer as correct
+    bool printQuestionBox(string_view question, string_view answer, int qnum) const {
         cout << "\n+==============================+\n";
         cout << "| Question " << qnum << ":\n";
-        cout << "| " << q.question << "\n";
+        cout << "| " << question << "\n";
         cout << "+==============================+\n";
 
         cout << "Your answer: ";
@@ -261,7 +1841,7 @@ private:
 
         cout << "\n+==============================+\n";
         cout << "| Correct answer:\n";
-        cout << "| " << q.answer << "\n";
+        cout << "| " << answer << "\n";
         cout << "+==============================+\n";
 
         char correct;
@@ -280,6 +1860,7 @@ private:
             cout << "Incorrect. Review this question again!\n";
         }
         cout << endl;
+        return correct == 'y';
     }
 
     int inputInt(int min, int max) const {
@@ -307,7 +1888,81 @@ private:
         }
     }
 
+    static bool writeWholeFile(const string& path, const string& data) {
+        FILE* f = fopen(path.c_str(), "wb");
+        if (!f) return false;
+        bool ok = fwrite(data.data(), 1, data.size(), f) == data.size();
+        return fclose(f) == 0 && ok;
+    }
+
+    static unsigned exportThreadCount(size_t deckCount) {
+        unsigned hw = thread::hardware_concurrency();
+        if (hw == 0) hw = 1;
+        return (unsigned)min<size_t>(hw, deckCount);
+    }
+
+    // One file per deck: worker threads take decks from a shared counter,
+    // serialize each into their own buffer and write it in a single call.
+    // Returns the number of decks written.
+    size_t exportPerDeck(const vector<const Flashcard*>& decks, ExportFormat format) const {
+        unsigned threadCount = exportThreadCount(decks.size());
+        atomic<size_t> nextDeck(0);
+        atomic<size_t> written(0);
+        vector<thread> workers;
+        for (unsigned t = 0; t < threadCount; ++t) {
+            workers.emplace_back([&]() {
+                string buffer;
+                size_t i;
+                while ((i = nextDeck++) < decks.size()) {
+                    const Flashcard& fc = *decks[i];
+                    buffer = exportHeader(format, fc.title, false);
+                    serializeDeck(fc, format, false, buffer);
+                    string path = exportFolderName + "/" + fc.title + exportExtension(format);
+                    if (writeWholeFile(path, buffer)) written++;
+                }
+            });
+        }
+        for (thread& w : workers) w.join();
+        return written;
+    }
+
+    // One combined file: decks are serialized in parallel one batch (a deck
+    // per thread) at a time, then appended in order, so memory use stays
+    // bounded by the batch rather than the whole export.
+    size_t exportCombined(const vector<const Flashcard*>& decks, ExportFormat format) const {
+        string path = exportFolderName + "/flashcards" + exportExtension(format);
+        FILE* out = fopen(path.c_str(), "wb");
+        if (!out) return 0;
+        setvbuf(out, nullptr, _IOFBF, 1 << 20);
+
+        string header = exportHeader(format, "", true);
+        bool ok = fwrite(header.data(), 1, header.size(), out) == header.size();
+
+        unsigned threadCount = exportThreadCount(decks.size());
+        vector<string> buffers(threadCount);
+        size_t written = 0;
+        for (size_t base = 0; ok && base < decks.size(); base += threadCount) {
+            size_t batch = min<size_t>(threadCount, decks.size() - base);
+            vector<thread> workers;
+            for (size_t t = 0; t < batch; ++t) {
+                workers.emplace_back([&, t]() {
+                    buffers[t].clear();
+                    serializeDeck(*decks[base + t], format, true, buffers[t]);
+                });
+            }
+            for (thread& w : workers) w.join();
+            for (size_t t = 0; ok && t < batch; ++t) {
+                ok = fwrite(buffers[t].data(), 1, buffers[t].size(), out) == buffers[t].size();
+                if (ok) written++;
+            }
+        }
+        if (fclose(out) != 0) return 0;
+        return written;
+    }
+
 public:
+    explicit FlashcardManager(const string& folder = "flashcards") : folderName(folder) {}
+
     void addCard() {
         string title;
         cout << "\n+======== Add New Flashcard ========+\n";
@@ -345,10 +2000,14 @@ public:
             getline(cin, questionText);
             cout << "Enter answer: ";
             getline(cin, answerText);
-            newFlashcard.questions.push_back(Question(questionText, answerText));
+            newFlashcard.questions.add(questionText, answerText);
         }
 
-        cards.insert(newFlashcard);
+        // History left by an earlier deck with this title is not carried over
+        reviewLog.retireDeck(title);
+        cards.insert(std::move(newFlashcard));
+        tagIndexDirty = true;
+        Flashcard& saved = cards.getTail()->data;
 
         char saveChoice;
         while (true) {
@@ -360,7 +2019,7 @@ public:
             cout << "Invalid input! Please enter 'y' or 'n'.\n";
         }
         if (saveChoice == 'y') {
-            saveToFile(newFlashcard);
+            saveToFile(saved);
         }
     }
 
@@ -394,6 +2053,7 @@ public:
         }
 
         Flashcard& fc = targetNode->data;  
+        tagIndexDirty = true;
 
         // Menu
         bool editDone = false;
@@ -404,10 +2064,11 @@ public:
             cout << "| 3. Add new question                     |\n";
             cout << "| 4. Delete a question                    |\n";
             cout << "| 5. Save changes to file                 |\n";
-            cout << "| 6. Done (back to main menu)             |\n";
+            cout << "| 6. Edit tags                            |\n";
+            cout << "| 7. Done (back to main menu)             |\n";
             cout << "+=========================================+\n";
             cout << "Enter choice > ";
-            int editChoice = inputInt(1, 6);
+            int editChoice = inputInt(1, 7);
 
             switch (editChoice) {
 
@@ -438,7 +2099,12 @@ public:
                         break;
                     }
                     
-                    deleteFile(fc.title);
+                    if (fc.damaged) {
+                        cout << "The damaged file for \"" << fc.title << "\" is kept as it is.\n";
+                    } else {
+                        deleteFile(fc.title);
+                    }
+                    reviewLog.renameDeck(fc.title, newTitle);
                     cout << "Title changed: \"" << fc.title << "\" -> \"" << newTitle << "\"\n";
                     fc.title = newTitle;
                     break;
@@ -452,12 +2118,12 @@ public:
                     }
                     cout << "\n--- Questions in \"" << fc.title << "\" ---\n";
                     for (size_t i = 0; i < fc.questions.size(); ++i) {
-                        cout << i+1 << ". Q: " << fc.questions[i].question << "\n";
-                        cout << "   A: " << fc.questions[i].answer << "\n";
+                        cout << i+1 << ". Q: " << fc.questions.question(i) << "\n";
+                        cout << "   A: " << fc.questions.answer(i) << "\n";
                     }
                     cout << "Enter question number to edit (1-" << fc.questions.size() << "): ";
                     int qChoice = inputInt(1, (int)fc.questions.size());
-                    Question& q = fc.questions[qChoice - 1];
+                    size_t q = qChoice - 1;
 
                     cout << "\n--- Editing Question " << qChoice << " ---\n";
                     cout << "| 1. Edit question text\n";
@@ -466,15 +2132,18 @@ public:
                     cout << "Enter choice > ";
                     int subChoice = inputInt(1, 3);
 
+                    string newText;
                     if (subChoice == 1 || subChoice == 3) {
-                        cout << "Current question: " << q.question << "\n";
+                        cout << "Current question: " << fc.questions.question(q) << "\n";
                         cout << "New question: ";
-                        getline(cin, q.question);
+                        getline(cin, newText);
+                        fc.questions.setQuestion(q, newText);
                     }
                     if (subChoice == 2 || subChoice == 3) {
-                        cout << "Current answer: " << q.answer << "\n";
+                        cout << "Current answer: " << fc.questions.answer(q) << "\n";
                         cout << "New answer: ";
-                        getline(cin, q.answer);
+                        getline(cin, newText);
+                        fc.questions.setAnswer(q, newText);
                     }
                     cout << "Question updated!\n";
                     break;
@@ -488,7 +2157,7 @@ public:
                     getline(cin, questionText);
                     cout << "Enter answer: ";
                     getline(cin, answerText);
-                    fc.questions.push_back(Question(questionText, answerText));
+                    fc.questions.add(questionText, answerText);
                     cout << "Question added! Total questions: " << fc.questions.size() << "\n";
                     break;
                 }
@@ -501,15 +2170,15 @@ public:
                     }
                     cout << "\n--- Questions in \"" << fc.title << "\" ---\n";
                     for (size_t i = 0; i < fc.questions.size(); ++i) {
-                        cout << i+1 << ". Q: " << fc.questions[i].question << "\n";
-                        cout << "   A: " << fc.questions[i].answer << "\n";
+                        cout << i+1 << ". Q: " << fc.questions.question(i) << "\n";
+                        cout << "   A: " << fc.questions.answer(i) << "\n";
                     }
                     cout << "Enter question number to delete (1-" << fc.questions.size() << "): ";
                     int delChoice = inputInt(1, (int)fc.questions.size());
 
                     char confirm;
                     while (true) {
-                        cout << "Delete question " << delChoice << " \"" << fc.questions[delChoice-1].question << "\"? (y/n): ";
+                        cout << "Delete question " << delChoice << " \"" << fc.questions.question(delChoice-1) << "\"? (y/n): ";
                         cin >> confirm;
                         cin.ignore();
                         confirm = tolower(confirm);
@@ -517,7 +2186,7 @@ public:
                         cout << "Invalid input! Please enter 'y' or 'n'.\n";
                     }
                     if (confirm == 'y') {
-                        fc.questions.erase(fc.questions.begin() + delChoice - 1);
+                        fc.questions.erase(delChoice - 1);
                         cout << "Question deleted! Total questions: " << fc.questions.size() << "\n";
                     } else {
                         cout << "Cancelled.\n";
@@ -527,12 +2196,68 @@ public:
 
                 // --- Save to file ---
                 case 5: {
+                    if (fc.damaged) {
+                        char overwrite;
+                        while (true) {
+                            cout << "\"" << fc.title << "\" was loaded from a damaged file and only "
+                                 << fc.questions.size() << " question(s) could be read.\n";
+                            cout << "Overwrite the file with them anyway? (y/n): ";
+                            cin >> overwrite;
+                            cin.ignore();
+                            overwrite = tolower(overwrite);
+                            if (overwrite == 'y' || overwrite == 'n') break;
+                            cout << "Invalid input! Please enter 'y' or 'n'.\n";
+                        }
+                        if (overwrite != 'y') {
+                            cout << "Cancelled.\n";
+                            break;
+                        }
+                        fc.damaged = false;
+                    }
                     saveToFile(fc);
                     break;
                 }
 
-                // --- Exit ---
+                // --- Tags ---
                 case 6: {
+                    cout << "\n--- Editing Tags ---\n";
+                    cout << "| 1. Edit flashcard tags (apply to all questions)\n";
+                    cout << "| 2. Edit tags of a question\n";
+                    cout << "Enter choice > ";
+                    int tagChoice = inputInt(1, 2);
+
+                    string newTags;
+                    if (tagChoice == 1) {
+                        cout << "Current tags: " << (fc.tags.empty() ? "(none)" : fc.tags) << "\n";
+                        cout << "New tags (separated by spaces, empty to clear): ";
+                        getline(cin, newTags);
+                        fc.tags = normalizeTags(newTags);
+                    } else {
+                        if (fc.questions.empty()) {
+                            cout << "No questions to tag!\n";
+                            break;
+                        }
+                        cout << "\n--- Questions in \"" << fc.title << "\" ---\n";
+                        for (size_t i = 0; i < fc.questions.size(); ++i) {
+                            cout << i+1 << ". Q: " << fc.questions.question(i) << "\n";
+                            if (!fc.questions.tags(i).empty()) {
+                                cout << "   Tags: " << fc.questions.tags(i) << "\n";
+                            }
+                        }
+                        cout << "Enter question number to tag (1-" << fc.questions.size() << "): ";
+                        int qChoice = inputInt(1, (int)fc.questions.size());
+                        string_view current = fc.questions.tags(qChoice - 1);
+                        cout << "Current tags: " << (current.empty() ? "(none)" : current) << "\n";
+                        cout << "New tags (separated by spaces, empty to clear): ";
+                        getline(cin, newTags);
+                        fc.questions.setTags(qChoice - 1, normalizeTags(newTags));
+                    }
+                    cout << "Tags updated!\n";
+                    break;
+                }
+
+                // --- Exit ---
+                case 7: {
                     editDone = true;
                     cout << "Done editing \"" << fc.title << "\".\n";
                     break;
@@ -547,31 +2272,60 @@ public:
             return;
         }
 
+        loadSettings();
         cards = CircularLinkedList<Flashcard>();
+        tagIndexDirty = true;
 
         int loadedCount = 0;
         vector<string> files = listTxtFiles(folderName);
         for (const string& filename : files) {
             string filepath = folderName + "/" + filename;
 
-            ifstream inputFile(filepath);
-            if (!inputFile) continue;
+            DeckReader inputFile;
+            if (!inputFile.open(filepath)) continue;
 
             string title = filename.substr(0, filename.find_last_of('.'));
             Flashcard newFlashcard(title);
 
+            // The file size bounds the text buffer, so it is allocated once
+            struct stat info;
+            if (stat(filepath.c_str(), &info) == 0) {
+                newFlashcard.questions.reserve(0, (size_t)info.st_size);
+            }
+
+            // Question lines are described at parseQuestionLine; questions
+            // without an id follow on from the previous one. A line without
+            // '|' is never a question: "#tags: a b" holds the deck tags and
+            // "#next-id: N" the next question id.
+            const string_view tagMarker = "#tags:";
+            const string_view nextIdMarker = "#next-id:";
+            uint32_t impliedId = 0;
             string line;
-            while (getline(inputFile, line)) {
+            while (inputFile.readLine(line)) {
                 if (line.empty()) continue;
-                size_t separatorIndex = line.find('|');
-                if (separatorIndex != string::npos) {
-                    string questionText = line.substr(0, separatorIndex);
-                    string answerText = line.substr(separatorIndex + 1);
-                    newFlashcard.questions.push_back(Question(questionText, answerText));
+                string_view text(line);
+                QuestionLine parsed;
+                if (!parseQuestionLine(text, parsed)) {
+                    uint32_t nextId;
+                    if (text.substr(0, tagMarker.size()) == tagMarker) {
+                        newFlashcard.tags = normalizeTags(text.substr(tagMarker.size()));
+                    } else if (text.substr(0, nextIdMarker.size()) == nextIdMarker &&
+                               parseId(text.substr(nextIdMarker.size()), nextId)) {
+                        newFlashcard.questions.reserveIds(nextId);
+                    }
+                    continue;
                 }
+                uint32_t id = parsed.hasId ? parsed.id : impliedId;
+                newFlashcard.questions.addWithId(id, parsed.question, parsed.answer, parsed.tags);
+                impliedId = max(impliedId, id + 1);
+            }
+            if (inputFile.isDamaged()) {
+                newFlashcard.damaged = true;
+                cout << "Warning: " << filepath << " is damaged; loaded "
+                     << newFlashcard.questions.size() << " question(s) from it. "
+                     << "It will not be overwritten unless you confirm.\n";
             }
-            inputFile.close();
-            cards.insert(newFlashcard);
+            cards.insert(std::move(newFlashcard));
             loadedCount++;
         }
 
@@ -642,8 +2396,11 @@ public:
             // Display questions in order (shuffled or normal)
             for (size_t i = 0; i < questionOrder.size(); ++i) {
                 int qIdx = questionOrder[i];
-                printQuestionBox(currentNode->data.questions[qIdx], i + 1);
+                const QuestionStore& questions = currentNode->data.questions;
+                bool correct = printQuestionBox(questions.question(qIdx), questions.answer(qIdx), i + 1);
+                reviewLog.record(currentNode->data.title, questions.id(qIdx), correct);
             }
+            saveReviewHistory();
 
             currentNode = currentNode->next;
 
@@ -675,9 +2432,406 @@ public:
         int idx = 1;
         do {
             cout << idx++ << ". " << curr->data.title
+                 << " (" << curr->data.questions.size() << " questions)";
+            if (!curr->data.tags.empty()) {
+                cout << " [tags: " << curr->data.tags << "]";
+            }
+            cout << "\n";
+            curr = curr->next;
+        } while (curr != cards.getHead());
+    }
+
+    //////////////////////////////////////////////////////////////
+    // DRILL WEAK CARDS
+    //////////////////////////////////////////////////////////////
+    void drillWeakCards() {
+        if (cards.isEmpty()) {
+            cout << "\nNo flashcards loaded.\n";
+            return;
+        }
+
+        // Number every question of every deck
+        vector<Flashcard*> deckOf;
+        vector<uint32_t> indexInDeck;
+        unordered_map<string, pair<Flashcard*, size_t>> firstId;
+        Node<Flashcard>* curr = cards.getHead();
+        do {
+            firstId[curr->data.title] = { &curr->data, deckOf.size() };
+            for (size_t i = 0; i < curr->data.questions.size(); ++i) {
+                deckOf.push_back(&curr->data);
+                indexInDeck.push_back((uint32_t)i);
+            }
+            curr = curr->next;
+        } while (curr != cards.getHead());
+        if (deckOf.empty()) {
+            cout << "\nNo questions to drill.\n";
+            return;
+        }
+
+        // Replay the review history into per-card error rates
+        vector<double> errorRate(deckOf.size(), DRILL_PRIOR_ERROR);
+        const vector<string>& logDecks = reviewLog.getDeckNames();
+        // The log refers to questions by id; map each id to its card
+        // number plus one, so 0 means the question no longer exists
+        vector<QuestionIdTable<uint32_t>> cardOfId(logDecks.size());
+        for (size_t d = 0; d < logDecks.size(); ++d) {
+            auto it = firstId.find(logDecks[d]);
+            if (it == firstId.end()) continue;
+            const QuestionStore& questions = it->second.first->questions;
+            for (size_t i = 0; i < questions.size(); ++i) {
+                cardOfId[d][questions.id(i)] = (uint32_t)(it->second.second + i + 1);
+            }
+        }
+        reviewLog.forEachBlock([&](const LogBlock& b) {
+            for (uint32_t i = 0; i < b.count; ++i) {
+                uint16_t d = b.deckId[i];
+                if (d >= cardOfId.size() || cardOfId[d].empty()) continue;
+                const uint32_t* card = cardOfId[d].find(b.questionId[i]);
+                if (!card || *card == 0) continue;
+                updateErrorRate(errorRate[*card - 1], !b.correct(i));
+            }
+        });
+
+        vector<double> weights(deckOf.size());
+        for (size_t i = 0; i < weights.size(); ++i) {
+            weights[i] = DRILL_MIN_WEIGHT + errorRate[i];
+        }
+        AliasTable table;
+        table.build(weights);
+
+        cout << "\n+======== Drill Weak Cards ========+\n";
+        cout << "Cards you often get wrong will come up more often.\n";
+        cout << "How many cards to drill (1-1000)? ";
+        int count = inputInt(1, 1000);
+
+        mt19937_64 rng((uint64_t)time(0));
+        uint32_t last = UINT32_MAX;
+        int answersSinceRebuild = 0;
+        for (int i = 0; i < count; ++i) {
+            // Avoid showing the same card twice in a row when possible
+            uint32_t id = table.sample(rng);
+            for (int tries = 0; id == last && tries < 3; ++tries) {
+                id = table.sample(rng);
+            }
+            last = id;
+
+            const Flashcard& fc = *deckOf[id];
+            uint32_t q = indexInDeck[id];
+            cout << "\n[Flashcard: " << fc.title << " | recent error rate: "
+                 << (int)(errorRate[id] * 100 + 0.5) << "%]";
+            bool correct = printQuestionBox(fc.questions.question(q), fc.questions.answer(q), i + 1);
+            reviewLog.record(fc.title, fc.questions.id(q), correct);
+
+            updateErrorRate(errorRate[id], !correct);
+            weights[id] = DRILL_MIN_WEIGHT + errorRate[id];
+            if (++answersSinceRebuild >= DRILL_REBUILD_BATCH) {
+                table.build(weights);
+                answersSinceRebuild = 0;
+            }
+        }
+        saveReviewHistory();
+        cout << "[Drill complete!]\n";
+    }
+
+    //////////////////////////////////////////////////////////////
+    // REVIEW BY TAG QUERY
+    //////////////////////////////////////////////////////////////
+    void reviewByTags() {
+        if (cards.isEmpty()) {
+            cout << "\nNo flashcards loaded.\n";
+            return;
+        }
+        if (tagIndexDirty) {
+            tagIndex.build(cards);
+            tagIndexDirty = false;
+        }
+
+        cout << "\n+======== Review by Tag Query ========+\n";
+        if (tagIndex.byTag.empty()) {
+            cout << "No tags yet. Add tags with Edit Flashcard > Edit tags.\n";
+            return;
+        }
+        vector<pair<string, size_t>> tagCounts;
+        for (const auto& entry : tagIndex.byTag) {
+            tagCounts.push_back({ entry.first, entry.second.cardinality() });
+        }
+        sort(tagCounts.begin(), tagCounts.end());
+        cout << "Tags:";
+        for (const auto& tc : tagCounts) {
+            cout << " " << tc.first << " (" << tc.second << ")";
+        }
+        cout << "\nCombine tags with AND, OR, NOT and parentheses,\n";
+        cout << "e.g. (networking AND os) NOT easy\n";
+
+        RoaringBitmap selected;
+        string query, error;
+        while (true) {
+            cout << "Enter tag query: ";
+            getline(cin, query);
+            if (tagIndex.query(query, selected, error)) break;
+            cout << "Invalid query: " << error << "\n";
+        }
+
+        vector<int> order;
+        order.reserve(selected.cardinality());
+        selected.forEach([&](uint32_t id) { order.push_back((int)id); });
+        if (order.empty()) {
+            cout << "No questions match \"" << query << "\".\n";
+            return;
+        }
+        cout << order.size() << " question(s) match.\n";
+
+        char shuffleChoice;
+        while (true) {
+            cout << "Enable shuffle mode? (y/n): ";
+            cin >> shuffleChoice;
+            cin.ignore();
+            shuffleChoice = tolower(shuffleChoice);
+            if (shuffleChoice == 'y' || shuffleChoice == 'n') break;
+            cout << "Invalid input! Please enter 'y' or 'n'.\n";
+        }
+        if (shuffleChoice == 'y') {
+            shuffleIndices(order);
+        }
+
+        cout << "How many questions to review (1-" << order.size() << ")? ";
+        int count = inputInt(1, (int)order.size());
+
+        for (int i = 0; i < count; ++i) {
+            const Flashcard& fc = *tagIndex.deckOf[order[i]];
+            uint32_t q = tagIndex.indexInDeck[order[i]];
+            cout << "\n[Flashcard: " << fc.title << "]";
+            bool correct = printQuestionBox(fc.questions.question(q), fc.questions.answer(q), i + 1);
+            reviewLog.record(fc.title, fc.questions.id(q), correct);
+        }
+        saveReviewHistory();
+        cout << "[Tag review complete!]\n";
+    }
+
+    //////////////////////////////////////////////////////////////
+    // REVIEW STATISTICS
+    //////////////////////////////////////////////////////////////
+    void showStats() {
+        auto start = chrono::steady_clock::now();
+        ReviewStats stats;
+        bool ok = reviewLog.computeStats(stats);
+        double elapsedMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+        if (stats.totalEvents == 0) {
+            cout << "\nNo review history yet. Review some cards first!\n";
+            return;
+        }
+        if (!ok) {
+            cout << "\nWarning: review history is damaged; showing what could be read.\n";
+        }
+
+        const vector<string>& deckNames = reviewLog.getDeckNames();
+        auto deckName = [&](size_t id) -> string {
+            if (id >= deckNames.size()) return "(unknown deck)";
+            return deckNames[id].empty() ? "(deleted deck)" : deckNames[id];
+        };
+        auto percent = [](uint64_t part, uint64_t whole) {
+            return whole ? 100.0 * part / whole : 0.0;
+        };
+
+        cout << "\n+======== Review Statistics ========+\n";
+        cout << left << setw(24) << "Deck" << right
+             << setw(9) << "Answers" << setw(10) << "Accuracy"
+             << setw(8) << "Streak" << setw(6) << "Best"
+             << setw(12) << "Trend (7d)" << "\n";
+        cout << fixed << setprecision(1);
+        for (size_t d = 0; d < stats.decks.size(); ++d) {
+            const DeckStats& ds = stats.decks[d];
+            if (ds.attempts == 0) continue;
+            string trend = "n/a";
+            if (ds.recentAttempts && ds.priorAttempts) {
+                double diff = percent(ds.recentCorrect, ds.recentAttempts)
+                            - percent(ds.priorCorrect, ds.priorAttempts);
+                char buf[16];
+                snprintf(buf, sizeof(buf), "%+.1f%%", diff);
+                trend = buf;
+            }
+            cout << left << setw(24) << deckName(d).substr(0, 23) << right
+                 << setw(9) << ds.attempts
+                 << setw(9) << percent(ds.correct, ds.attempts) << "%"
+                 << setw(8) << ds.currentStreak << setw(6) << ds.bestStreak
+                 << setw(12) << trend << "\n";
+        }
+
+        // Weakest questions: lowest accuracy among those answered a few
+        // times that still exist (history is kept by question id)
+        struct WeakQuestion { const Flashcard* fc; size_t index; const QuestionStats* qs; double accuracy; };
+        vector<WeakQuestion> weak;
+        for (size_t d = 0; d < stats.questions.size(); ++d) {
+            const Flashcard* fc = nullptr;
+            if (d < deckNames.size() && !deckNames[d].empty()) {
+                fc = findByTitle(deckNames[d]);
+            }
+            if (!fc || stats.questions[d].empty()) continue;
+            for (size_t i = 0; i < fc->questions.size(); ++i) {
+                const QuestionStats* qs = stats.questions[d].find(fc->questions.id(i));
+                if (qs && qs->attempts >= 3 && qs->correct < qs->attempts) {
+                    weak.push_back({ fc, i, qs, percent(qs->correct, qs->attempts) });
+                }
+            }
+        }
+        size_t shown = min<size_t>(weak.size(), 10);
+        partial_sort(weak.begin(), weak.begin() + shown, weak.end(),
+                     [](const WeakQuestion& a, const WeakQuestion& b) { return a.accuracy < b.accuracy; });
+
+        if (shown > 0) {
+            cout << "\n--- Most missed questions ---\n";
+            for (size_t i = 0; i < shown; ++i) {
+                const WeakQuestion& w = weak[i];
+                cout << i + 1 << ". [" << w.fc->title << "] " << w.fc->questions.question(w.index)
+                     << " - " << w.qs->correct << "/" << w.qs->attempts
+                     << " correct (" << w.accuracy << "%)\n";
+            }
+        }
+        cout.unsetf(ios::fixed);
+        cout << setprecision(6);
+
+        cout << "\nScanned " << stats.totalEvents << " review(s) in "
+             << (long long)elapsedMs << " ms.\n";
+    }
+
+    //////////////////////////////////////////////////////////////
+    // EXPORT
+    //////////////////////////////////////////////////////////////
+    void exportCards() const {
+        if (cards.isEmpty()) {
+            cout << "\nNo flashcards loaded.\n";
+            return;
+        }
+
+        cout << "\n+======== Export Flashcards ========+\n";
+        cout << "| 1. CSV                            |\n";
+        cout << "| 2. JSON Lines                     |\n";
+        cout << "| 3. Anki (tab-separated text)      |\n";
+        cout << "+===================================+\n";
+        cout << "Enter format > ";
+        int formatChoice = inputInt(1, 3);
+        ExportFormat format = formatChoice == 1 ? ExportFormat::CSV
+                            : formatChoice == 2 ? ExportFormat::JSONL
+                            : ExportFormat::ANKI;
+
+        vector<const Flashcard*> all;
+        cout << "\n--- Flashcards ---\n";
+        Node<Flashcard>* curr = cards.getHead();
+        do {
+            all.push_back(&curr->data);
+            cout << all.size() << ". " << curr->data.title
                  << " (" << curr->data.questions.size() << " questions)\n";
             curr = curr->next;
         } while (curr != cards.getHead());
+
+        vector<const Flashcard*> selected;
+        while (selected.empty()) {
+            cout << "Enter flashcard numbers separated by spaces (0 = all): ";
+            string line, token;
+            getline(cin, line);
+            istringstream numbers(line);
+            vector<bool> picked(all.size(), false);
+            bool valid = true;
+            bool everything = false;
+            while (numbers >> token) {
+                char* end;
+                long n = strtol(token.c_str(), &end, 10);
+                if (*end != '\0' || n < 0 || n > (long)all.size()) {
+                    valid = false;
+                    break;
+                }
+                if (n == 0) {
+                    everything = true;
+                } else if (!picked[n - 1]) {
+                    picked[n - 1] = true;
+                    selected.push_back(all[n - 1]);
+                }
+            }
+            if (everything) selected = all;
+            if (!valid || selected.empty()) {
+                cout << "Invalid input! Please enter numbers between 0 and " << all.size() << ".\n";
+                selected.clear();
+            }
+        }
+
+        char combinedChoice;
+        while (true) {
+            cout << "Write everything into a single file? (y/n): ";
+            cin >> combinedChoice;
+            cin.ignore();
+            combinedChoice = tolower(combinedChoice);
+            if (combinedChoice == 'y' || combinedChoice == 'n') break;
+            cout << "Invalid input! Please enter 'y' or 'n'.\n";
+        }
+        bool combined = (combinedChoice == 'y');
+
+        if (!dirExists(exportFolderName)) {
+            createDir(exportFolderName);
+        }
+
+        auto start = chrono::steady_clock::now();
+        size_t written = combined ? exportCombined(selected, format)
+                                  : exportPerDeck(selected, format);
+        double elapsedMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+        size_t totalQuestions = 0;
+        for (const Flashcard* fc : selected) totalQuestions += fc->questions.size();
+        if (written < selected.size()) {
+            cout << "Error: " << selected.size() - written << " flashcard(s) could not be exported!\n";
+        }
+        cout << "Exported " << written << " flashcard(s) (" << totalQuestions << " questions) to "
+             << (combined ? exportFolderName + "/flashcards" + exportExtension(format)
+                          : exportFolderName + "/")
+             << " in " << (long long)elapsedMs << " ms.\n";
+    }
+
+    //////////////////////////////////////////////////////////////
+    // STORAGE SETTINGS
+    //////////////////////////////////////////////////////////////
+    void storageSettings() {
+        cout << "\n+======== Storage Settings ========+\n";
+        cout << "Deck compression level: " << compressionLevel
+             << (compressionLevel == 0 ? " (off, plain text)" : "") << "\n";
+        cout << "0 = plain text, 1 = fastest saving ... 9 = smallest files.\n";
+        cout << "Compressed decks are detected automatically when loading.\n";
+        cout << "Enter new level (0-9): ";
+        compressionLevel = inputInt(0, 9);
+        saveSettings();
+        cout << "Compression level set to " << compressionLevel << ".\n";
+
+        if (cards.isEmpty()) return;
+        char rewriteChoice;
+        while (true) {
+            cout << "Rewrite all loaded flashcards with this setting now? (y/n): ";
+            cin >> rewriteChoice;
+            cin.ignore();
+            rewriteChoice = tolower(rewriteChoice);
+            if (rewriteChoice == 'y' || rewriteChoice == 'n') break;
+            cout << "Invalid input! Please enter 'y' or 'n'.\n";
+        }
+        if (rewriteChoice != 'y') return;
+
+        auto folderSize = [&]() {
+            long long total = 0;
+            for (const string& name : listTxtFiles(folderName)) {
+                struct stat info;
+                if (stat((folderName + "/" + name).c_str(), &info) == 0) total += info.st_size;
+            }
+            return total;
+        };
+        long long before = folderSize();
+        Node<Flashcard>* curr = cards.getHead();
+        do {
+            saveToFile(curr->data);
+            curr = curr->next;
+        } while (curr != cards.getHead());
+        auto formatSize = [](long long bytes) {
+            if (bytes < 10 * 1024) return to_string(bytes) + " bytes";
+            if (bytes < 10 * 1024 * 1024) return to_string(bytes / 1024) + " KB";
+            return to_string(bytes / (1024 * 1024)) + " MB";
+        };
+        cout << "Flashcard files: " << formatSize(before) << " -> " << formatSize(folderSize()) << "\n";
     }
 
     //////////////////////////////////////////////////////////////
@@ -725,10 +2879,14 @@ public:
         if (confirm == 'y') {
             // Delete from memory
             cards.removeAt(choice);
+            tagIndexDirty = true;
 
             // Delete from file
             deleteFile(titleToDelete);
 
+            // Its history stays in the log but no longer follows the title
+            reviewLog.retireDeck(titleToDelete);
+
             cout << "Flashcard \"" << titleToDelete << "\" deleted successfully!\n";
         } else {
             cout << "Deletion cancelled.\n";
@@ -736,6 +2894,166 @@ public:
     }
 };
 
+//////////////////////////////////////////////////////////////
+// BENCHMARKS
+//////////////////////////////////////////////////////////////
+// Resident memory of this process in bytes, or 0 where it is unknown
+size_t residentBytes() {
+#ifdef __linux__
+    ifstream statm("/proc/self/statm");
+    size_t pages = 0, resident = 0;
+    if (statm >> pages >> resident) return resident * (size_t)sysconf(_SC_PAGESIZE);
+#endif
+    return 0;
+}
+
+// Text of the benchmark decks: questionCount questions spread over 200
+// decks, made of random words with a Zipf-like frequency (about 100 bytes
+// per line). A fixed seed gives the same text on every run.
+vector<string> generateBenchDecks(size_t questionCount) {
+    const size_t deckCount = 200;
+    mt19937_64 rng(2026);
+    vector<string> words(20000);
+    for (string& w : words) {
+        size_t length = 3 + rng() % 8;
+        for (size_t i = 0; i < length; ++i) w += (char)('a' + rng() % 26);
+    }
+    // exp(u * ln n) is log-uniform, so word k is drawn with weight ~1/k
+    uniform_real_distribution<double> unit(0.0, 1.0);
+    const double logWords = log((double)words.size());
+    auto appendWords = [&](string& out, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            if (i) out += ' ';
+            size_t rank = min((size_t)exp(unit(rng) * logWords), words.size());
+            out += words[rank - 1];
+        }
+    };
+
+    vector<string> decks(deckCount);
+    for (size_t d = 0; d < deckCount; ++d) {
+        size_t first = questionCount * d / deckCount;
+        size_t last = questionCount * (d + 1) / deckCount;
+        string& text = decks[d];
+        for (size_t q = first; q < last; ++q) {
+            appendWords(text, 3 + rng() % 4);
+            text += "?|";
+            appendWords(text, 6 + rng() % 5);
+            text += '\n';
+        }
+    }
+    return decks;
+}
+
+void writeBenchDecks(const string& folder, const vector<string>& decks, int level) {
+    createDir(folder);
+    for (size_t d = 0; d < decks.size(); ++d) {
+        writeDeckFile(folder + "/deck" + to_string(d) + ".txt", decks[d], level);
+    }
+}
+
+void removeBenchDecks(const string& folder) {
+    for (const string& name : listTxtFiles(folder)) deleteFileFs(folder + "/" + name);
+    removeDirFs(folder);
+}
+
+// Benchmark for "--bench-memory [questions]": resident memory and heap
+// allocations taken by loading the generated decks
+int benchMemory(size_t questionCount) {
+    const string folder = "bench_decks";
+    if (dirExists(folder)) {
+        cout << "The folder \"" << folder << "\" already exists; remove it first.\n";
+        return 1;
+    }
+    size_t textBytes = 0;
+    {
+        vector<string> decks = generateBenchDecks(questionCount);
+        for (const string& text : decks) textBytes += text.size();
+        writeBenchDecks(folder, decks, 0);
+    }
+
+    size_t residentBefore = residentBytes();
+    uint64_t allocationsBefore = allocationCount.load();
+    {
+        FlashcardManager manager(folder);
+        cout.setstate(ios::failbit);  // silence the load message
+        manager.loadFlashcards();
+        cout.clear();
+
+        size_t residentAfter = residentBytes();
+        uint64_t allocations = allocationCount.load() - allocationsBefore;
+        cout << fixed << setprecision(1);
+        cout << "Loaded " << questionCount << " questions in 200 decks ("
+             << textBytes / 1e6 << " MB of deck text)\n";
+        if (residentAfter) {
+            cout << "  resident after load: " << residentAfter / 1e6 << " MB ("
+                 << (residentAfter - residentBefore) / 1e6 << " MB for the decks, "
+                 << (double)(residentAfter - residentBefore) / max<size_t>(questionCount, 1)
+                 << " bytes per question)\n";
+        } else {
+            cout << "  resident memory: not available on this system\n";
+        }
+        cout << "  operator new calls:  " << allocations << " ("
+             << setprecision(3) << (double)allocations / max<size_t>(questionCount, 1)
+             << " per question)\n";
+    }
+    removeBenchDecks(folder);
+    return 0;
+}
+
+// Benchmark for "--bench-load [questions]": disk size, save time and load
+// time of the generated decks stored as plain text and at several
+// compression levels. Loads are timed with the files already in the OS
+// cache (best of three).
+int benchLoad(size_t questionCount) {
+    using Clock = chrono::steady_clock;
+    auto msSince = [](Clock::time_point start) {
+        return chrono::duration<double, milli>(Clock::now() - start).count();
+    };
+    const string folder = "bench_decks";
+    if (dirExists(folder)) {
+        cout << "The folder \"" << folder << "\" already exists; remove it first.\n";
+        return 1;
+    }
+
+    vector<string> decks = generateBenchDecks(questionCount);
+    size_t textBytes = 0;
+    for (const string& text : decks) textBytes += text.size();
+
+    cout << fixed << setprecision(1);
+    cout << questionCount << " questions in 200 decks (" << textBytes / 1e6
+         << " MB of deck text)\n";
+    cout << left << setw(10) << "Storage" << right << setw(12) << "Disk (MB)"
+         << setw(12) << "Save (ms)" << setw(12) << "Load (ms)" << "\n";
+    for (int level : { 0, 1, 5, 9 }) {
+        auto start = Clock::now();
+        writeBenchDecks(folder, decks, level);
+        double saveMs = msSince(start);
+
+        size_t diskBytes = 0;
+        for (const string& name : listTxtFiles(folder)) {
+            struct stat info;
+            if (stat((folder + "/" + name).c_str(), &info) == 0) diskBytes += info.st_size;
+        }
+
+        double loadMs = 0;
+        for (int run = 0; run < 3; ++run) {
+            FlashcardManager manager(folder);
+            cout.setstate(ios::failbit);  // silence the load message
+            start = Clock::now();
+            manager.loadFlashcards();
+            double ms = msSince(start);
+            cout.clear();
+            loadMs = run == 0 ? ms : min(loadMs, ms);
+        }
+
+        string name = level == 0 ? "plain" : "level " + to_string(level);
+        cout << left << setw(10) << name << right << setw(12) << diskBytes / 1e6
+             << setw(12) << saveMs << setw(12) << loadMs << "\n";
+        removeBenchDecks(folder);
+    }
+    return 0;
+}
+
 //////////////////////////////////////////////////////////////
 // MENU
 //////////////////////////////////////////////////////////////
@@ -749,12 +3067,30 @@ void showMenu() {
     cout << "| 4. Reload Flashcards from folder    |\n";
     cout << "| 5. Review Cards                     |\n";
     cout << "| 6. Show All Flashcards              |\n";
-    cout << "| 7. Exit                             |\n";
+    cout << "| 7. Review Statistics                |\n";
+    cout << "| 8. Export Flashcards                |\n";
+    cout << "| 9. Review by Tag Query              |\n";
+    cout << "| 10. Drill Weak Cards                |\n";
+    cout << "| 11. Storage Settings                |\n";
+    cout << "| 12. Exit                            |\n";
     cout << "+====================================+\n";
     cout << "Enter choice > ";
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    if (argc >= 2 && string(argv[1]) == "--bench-alias") {
+        size_t cardCount = argc >= 3 ? strtoul(argv[2], nullptr, 10) : 1000000;
+        return benchAlias(max<size_t>(cardCount, 1));
+    }
+    if (argc >= 2 && string(argv[1]) == "--bench-memory") {
+        size_t questionCount = argc >= 3 ? strtoul(argv[2], nullptr, 10) : 1000000;
+        return benchMemory(questionCount);
+    }
+    if (argc >= 2 && string(argv[1]) == "--bench-load") {
+        size_t questionCount = argc >= 3 ? strtoul(argv[2], nullptr, 10) : 1000000;
+        return benchLoad(questionCount);
+    }
+
     // Initialize random seed for shuffle mode
     srand(time(0));
 
@@ -768,7 +3104,7 @@ int main() {
         if (!(cin >> userChoice)) {
         cin.clear();                
         cin.ignore(1000, '\n');      
-        cout << "Invalid input! Please enter a number 1-7.\n";
+        cout << "Invalid input! Please enter a number 1-12.\n";
         continue;                    
 }
 cin.ignore();
@@ -781,11 +3117,16 @@ cin.ignore();
             case 4: manager.loadFlashcards(); break;
             case 5: manager.reviewCards();    break;
             case 6: manager.showAll();        break;
-            case 7: cout << "Goodbye!\n";     break;
-            default: cout << "Invalid choice. Please enter 1-7.\n";
+            case 7: manager.showStats();      break;
+            case 8: manager.exportCards();    break;
+            case 9: manager.reviewByTags();   break;
+            case 10: manager.drillWeakCards(); break;
+            case 11: manager.storageSettings(); break;
+            case 12: cout << "Goodbye!\n";    break;
+            default: cout << "Invalid choice. Please enter 1-12.\n";
         }
 
-    } while (userChoice != 7);
+    } while (userChoice != 12);
 
     return 0;
 }
\ No newline at end of file